@@ -42,6 +42,9 @@ macro(__compiler_gnu lang)
     # internally, as it ought to.  Work around this bug by setting -MT here
     # even though it isn't strictly necessary.
     set(CMAKE_DEPFILE_FLAGS_${lang} "-MMD -MT <OBJECT> -MF <DEPFILE>")
+    # The Makefile generators track headers in SYSTEM include directories
+    # too, which -MMD leaves out.
+    set(CMAKE_MAKEFILE_DEPFILE_FLAGS_${lang} "-MD -MT <OBJECT> -MF <DEPFILE>")
   endif()
 
   # Initial configuration flags.
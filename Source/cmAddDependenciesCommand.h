@@ -37,6 +37,8 @@ public:
   virtual bool InitialPass(std::vector<std::string> const& args,
                            cmExecutionStatus &status);
 
+  virtual bool IsStateless() const { return true; }
+
   /**
    * The name of the command as specified in CMakeList.txt.
    */
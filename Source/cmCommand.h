@@ -88,6 +88,13 @@ public:
    */
   virtual bool HasFinalPass() const { return false; }
 
+  /**
+   * Can the command be invoked directly on its prototype instead of
+   * on a clone?  This is true for commands that keep no state of their
+   * own across InitialPass calls and never have a final pass.
+   */
+  virtual bool IsStateless() const { return false; }
+
   /**
    * This is a virtual constructor for the command.
    */
@@ -173,6 +180,14 @@ public:
     this->Error += e;
     }
 
+  /**
+   * Forget the error of a previous invocation.
+   */
+  void ClearError()
+    {
+    this->Error = "";
+    }
+
   /** Check if the command is disallowed by a policy.  */
   bool Disallowed(cmPolicies::PolicyID pol, const char* e)
     {
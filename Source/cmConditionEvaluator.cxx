@@ -11,6 +11,7 @@
 ============================================================================*/
 
 #include "cmConditionEvaluator.h"
+#include "cmRegularExpressionCache.h"
 
 cmConditionEvaluator::cmConditionEvaluator(cmMakefile& makefile):
   Makefile(makefile),
@@ -112,7 +113,7 @@ const char* cmConditionEvaluator::GetDefinitionIfUnquoted(
   if(def && argument.WasQuoted() && this->Policy54Status == cmPolicies::WARN)
     {
     bool hasBeenReported = this->Makefile.HasCMP0054AlreadyBeenReported(
-      this->Makefile.GetBacktrace()[0]);
+      this->Makefile.GetBacktrace().Top());
 
     if(!hasBeenReported)
       {
@@ -162,7 +163,7 @@ bool cmConditionEvaluator::IsKeyword(std::string const& keyword,
     this->Policy54Status == cmPolicies::WARN)
     {
     bool hasBeenReported = this->Makefile.HasCMP0054AlreadyBeenReported(
-      this->Makefile.GetBacktrace()[0]);
+      this->Makefile.GetBacktrace().Top());
 
     if(!hasBeenReported)
       {
@@ -551,7 +552,8 @@ bool cmConditionEvaluator::HandleLevel2(cmArgumentList &newArgs,
         const char* rex = argP2->c_str();
         this->Makefile.ClearMatches();
         cmsys::RegularExpression regEntry;
-        if ( !regEntry.compile(rex) )
+        if ( !cmRegularExpressionCache::Compile(regEntry,
+                                                argP2->GetValue()) )
           {
           std::ostringstream error;
           error << "Regular expression \"" << rex << "\" cannot compile";
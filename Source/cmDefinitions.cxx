@@ -14,10 +14,81 @@
 //----------------------------------------------------------------------------
 cmDefinitions::Def cmDefinitions::NoDef;
 
+//----------------------------------------------------------------------------
+cmDefinitions::Def::Def(const char* v)
+  : Value(v? new Shared(v) : 0), Exists(v? true : false)
+{
+}
+
+//----------------------------------------------------------------------------
+cmDefinitions::Def::Def(const std::string& v)
+  : Value(new Shared(v)), Exists(true)
+{
+}
+
+//----------------------------------------------------------------------------
+cmDefinitions::Def::Def(Def const& d)
+  : Value(d.Value), Exists(d.Exists)
+{
+  if(this->Value)
+    {
+    ++this->Value->RefCount;
+    }
+}
+
+//----------------------------------------------------------------------------
+cmDefinitions::Def& cmDefinitions::Def::operator=(Def const& d)
+{
+  if(d.Value)
+    {
+    ++d.Value->RefCount;
+    }
+  if(this->Value && --this->Value->RefCount == 0)
+    {
+    delete this->Value;
+    }
+  this->Value = d.Value;
+  this->Exists = d.Exists;
+  return *this;
+}
+
+//----------------------------------------------------------------------------
+cmDefinitions::Def::~Def()
+{
+  if(this->Value && --this->Value->RefCount == 0)
+    {
+    delete this->Value;
+    }
+}
+
 //----------------------------------------------------------------------------
 cmDefinitions::cmDefinitions(cmDefinitions* parent)
-  : Up(parent)
+  : Up(parent), Base(0)
+{
+}
+
+//----------------------------------------------------------------------------
+cmDefinitions::cmDefinitions(cmDefinitions const& r)
+  : Up(r.Up), Map(r.Map), Base(r.Base)
 {
+  Retain(this->Base);
+}
+
+//----------------------------------------------------------------------------
+cmDefinitions& cmDefinitions::operator=(cmDefinitions const& r)
+{
+  Retain(r.Base);
+  Release(this->Base);
+  this->Up = r.Up;
+  this->Map = r.Map;
+  this->Base = r.Base;
+  return *this;
+}
+
+//----------------------------------------------------------------------------
+cmDefinitions::~cmDefinitions()
+{
+  Release(this->Base);
 }
 
 //----------------------------------------------------------------------------
@@ -25,6 +96,96 @@ void cmDefinitions::Reset(cmDefinitions* parent)
 {
   this->Up = parent;
   this->Map.clear();
+  Release(this->Base);
+  this->Base = 0;
+}
+
+//----------------------------------------------------------------------------
+void cmDefinitions::Retain(Layer* layer)
+{
+  if(layer)
+    {
+    ++layer->RefCount;
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmDefinitions::Release(Layer* layer)
+{
+  while(layer && --layer->RefCount == 0)
+    {
+    Layer* base = layer->Base;
+    delete layer;
+    layer = base;
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmDefinitions::DropUnset(MapType& map)
+{
+  std::vector<std::string> unset;
+  for(MapType::const_iterator mi = map.begin(); mi != map.end(); ++mi)
+    {
+    if(!mi->second.Exists)
+      {
+      unset.push_back(mi->first);
+      }
+    }
+  for(std::vector<std::string>::const_iterator ui = unset.begin();
+      ui != unset.end(); ++ui)
+    {
+    map.erase(*ui);
+    }
+}
+
+//----------------------------------------------------------------------------
+cmDefinitions::Layer* cmDefinitions::PushLayer(MapType& map, Layer* base)
+{
+  // Take the given definitions.  Without a base layer nothing needs
+  // to be hidden so unset keys are dropped.
+  Layer* layer = new Layer;
+  layer->Map.swap(map);
+  layer->Base = base;
+  Retain(base);
+  if(!base)
+    {
+    DropUnset(layer->Map);
+    }
+
+  // Merge layers of comparable size so that the number of layers
+  // searched by a lookup stays logarithmic in the number of layers
+  // pushed, while each definition is copied only a few times.  The new
+  // layer is not shared yet, so the lower layers are merged into it.
+  // Copies share their values, so a lower layer is freed as soon as no
+  // other scope uses it.
+  while(layer->Base && layer->Base->Map.size() <= 2 * layer->Map.size())
+    {
+    Layer* lower = layer->Base;
+    for(MapType::const_iterator mi = lower->Map.begin();
+        mi != lower->Map.end(); ++mi)
+      {
+      layer->Map.insert(*mi);
+      }
+    layer->Base = lower->Base;
+    Retain(layer->Base);
+    Release(lower);
+    if(!layer->Base)
+      {
+      DropUnset(layer->Map);
+      }
+    }
+  return layer;
+}
+
+//----------------------------------------------------------------------------
+void cmDefinitions::Freeze()
+{
+  if(!this->Map.empty())
+    {
+    Layer* layer = PushLayer(this->Map, this->Base);
+    Release(this->Base);
+    this->Base = layer;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -42,6 +203,14 @@ cmDefinitions::GetInternal(const std::string& key)
     Def def = up->GetInternal(key);
     return this->Map.insert(MapType::value_type(key, def)).first->second;
     }
+  for(Layer const* layer = this->Base; layer; layer = layer->Base)
+    {
+    i = layer->Map.find(key);
+    if(i != layer->Map.end())
+      {
+      return i->second;
+      }
+    }
   return this->NoDef;
 }
 
@@ -49,7 +218,7 @@ cmDefinitions::GetInternal(const std::string& key)
 cmDefinitions::Def const&
 cmDefinitions::SetInternal(const std::string& key, Def const& def)
 {
-  if(this->Up || def.Exists)
+  if(this->Up || this->Base || def.Exists)
     {
     // In lower scopes we store keys, defined or not.
     return (this->Map[key] = def);
@@ -77,63 +246,73 @@ const char* cmDefinitions::Set(const std::string& key, const char* value)
 }
 
 //----------------------------------------------------------------------------
-std::set<std::string> cmDefinitions::LocalKeys() const
+void cmDefinitions::CollectKeys(MapType const& map,
+                                std::set<std::string>& defined,
+                                std::set<std::string>& undefined)
 {
-  std::set<std::string> keys;
-  // Consider local definitions.
-  for(MapType::const_iterator mi = this->Map.begin();
-      mi != this->Map.end(); ++mi)
+  for(MapType::const_iterator mi = map.begin(); mi != map.end(); ++mi)
     {
-    if (mi->second.Exists)
+    // Use this key if it is not already set or unset.
+    if(defined.find(mi->first) == defined.end() &&
+       undefined.find(mi->first) == undefined.end())
       {
-      keys.insert(mi->first);
+      std::set<std::string>& m = mi->second.Exists? defined : undefined;
+      m.insert(mi->first);
       }
     }
-  return keys;
-}
-
-//----------------------------------------------------------------------------
-cmDefinitions cmDefinitions::Closure() const
-{
-  return cmDefinitions(ClosureTag(), this);
 }
 
 //----------------------------------------------------------------------------
-cmDefinitions::cmDefinitions(ClosureTag const&, cmDefinitions const* root):
-  Up(0)
+std::set<std::string> cmDefinitions::LocalKeys() const
 {
+  // Shared definitions this scope is based on count as local.
+  std::set<std::string> defined;
   std::set<std::string> undefined;
-  this->ClosureImpl(undefined, root);
+  CollectKeys(this->Map, defined, undefined);
+  for(Layer const* layer = this->Base; layer; layer = layer->Base)
+    {
+    CollectKeys(layer->Map, defined, undefined);
+    }
+  return defined;
 }
 
 //----------------------------------------------------------------------------
-void cmDefinitions::ClosureImpl(std::set<std::string>& undefined,
-                                cmDefinitions const* defs)
+cmDefinitions cmDefinitions::Closure()
 {
-  // Consider local definitions.
-  for(MapType::const_iterator mi = defs->Map.begin();
-      mi != defs->Map.end(); ++mi)
+  // Freeze the definitions of the top-most scope so that the result
+  // can share them instead of copying them.
+  cmDefinitions* root = this;
+  while(root->Up)
     {
-    // Use this key if it is not already set or unset.
-    if(this->Map.find(mi->first) == this->Map.end() &&
-       undefined.find(mi->first) == undefined.end())
+    root = root->Up;
+    }
+  root->Freeze();
+
+  // Only the definitions of function scopes in between need a copy.
+  MapType overlay;
+  for(cmDefinitions const* defs = this; defs != root; defs = defs->Up)
+    {
+    for(MapType::const_iterator mi = defs->Map.begin();
+        mi != defs->Map.end(); ++mi)
       {
-      if(mi->second.Exists)
-        {
-        this->Map.insert(*mi);
-        }
-      else
+      if(overlay.find(mi->first) == overlay.end())
         {
-        undefined.insert(mi->first);
+        overlay.insert(*mi);
         }
       }
     }
 
-  // Traverse parents.
-  if(cmDefinitions const* up = defs->Up)
+  cmDefinitions closure;
+  if(overlay.empty())
     {
-    this->ClosureImpl(undefined, up);
+    closure.Base = root->Base;
+    Retain(closure.Base);
     }
+  else
+    {
+    closure.Base = PushLayer(overlay, root->Base);
+    }
+  return closure;
 }
 
 //----------------------------------------------------------------------------
@@ -150,21 +329,17 @@ void cmDefinitions::ClosureKeys(std::set<std::string>& defined,
                                 std::set<std::string>& undefined) const
 {
   // Consider local definitions.
-  for(MapType::const_iterator mi = this->Map.begin();
-      mi != this->Map.end(); ++mi)
-    {
-    // Use this key if it is not already set or unset.
-    if(defined.find(mi->first) == defined.end() &&
-       undefined.find(mi->first) == undefined.end())
-      {
-      std::set<std::string>& m = mi->second.Exists? defined : undefined;
-      m.insert(mi->first);
-      }
-    }
+  CollectKeys(this->Map, defined, undefined);
 
   // Traverse parents.
   if(cmDefinitions const* up = this->Up)
     {
     up->ClosureKeys(defined, undefined);
     }
+
+  // Traverse shared definitions.
+  for(Layer const* layer = this->Base; layer; layer = layer->Base)
+    {
+    CollectKeys(layer->Map, defined, undefined);
+    }
 }
@@ -22,13 +22,19 @@
  *
  * This stores the state of variable definitions (set or unset) for
  * one scope.  Sets are always local.  Gets search parent scopes
- * transitively and save results locally.
+ * transitively and save results locally.  A scope may also be based
+ * on immutable definitions shared with other scopes, e.g. the scope
+ * of the directory from which it was created.  These are searched
+ * last and never modified.
  */
 class cmDefinitions
 {
 public:
   /** Construct with the given parent scope.  */
   cmDefinitions(cmDefinitions* parent = 0);
+  cmDefinitions(cmDefinitions const& r);
+  cmDefinitions& operator=(cmDefinitions const& r);
+  ~cmDefinitions();
 
   /** Reset object as if newly constructed.  */
   void Reset(cmDefinitions* parent = 0);
@@ -47,23 +53,36 @@ public:
   std::set<std::string> LocalKeys() const;
 
   /** Compute the closure of all defined keys with values.
-      This flattens the scope.  The result has no parent.  */
-  cmDefinitions Closure() const;
+      The result has no parent.  It shares the definitions of this
+      scope instead of copying them, so they are frozen first.  */
+  cmDefinitions Closure();
 
   /** Compute the set of all defined keys.  */
   std::set<std::string> ClosureKeys() const;
 
 private:
-  // String with existence boolean.
-  struct Def: public std::string
+  // String with existence boolean.  The string is shared by all copies
+  // so that a value returned by Get() stays valid while any scope or
+  // layer still holds the definition.
+  struct Def
   {
+    Def(): Value(0), Exists(false) {}
+    Def(const char* v);
+    Def(const std::string& v);
+    Def(Def const& d);
+    Def& operator=(Def const& d);
+    ~Def();
+    const char* c_str() const
+      { return this->Value? this->Value->String.c_str() : ""; }
   private:
-    typedef std::string std_string;
+    struct Shared
+    {
+      Shared(std::string const& s): RefCount(1), String(s) {}
+      unsigned int RefCount;
+      std::string String;
+    };
+    Shared* Value;
   public:
-    Def(): std_string(), Exists(false) {}
-    Def(const char* v): std_string(v?v:""), Exists(v?true:false) {}
-    Def(const std_string& v): std_string(v), Exists(true) {}
-    Def(Def const& d): std_string(d), Exists(d.Exists) {}
     bool Exists;
   };
   static Def NoDef;
@@ -79,17 +98,35 @@ private:
 #endif
   MapType Map;
 
+  // Immutable definitions shared by any number of scopes.  Each layer
+  // overrides the layers below it.  Layers are reference counted and
+  // freed with the last scope or layer using them.
+  struct Layer
+  {
+    Layer(): RefCount(1), Base(0) {}
+    unsigned int RefCount;
+    MapType Map;
+    Layer* Base;
+  };
+  static void Retain(Layer* layer);
+  static void Release(Layer* layer);
+  static Layer* PushLayer(MapType& map, Layer* base);
+  static void DropUnset(MapType& map);
+
+  // Shared definitions below the local ones, if any.
+  Layer* Base;
+
+  // Move local definitions into a new shared layer.
+  void Freeze();
+
   // Internal query and update methods.
   Def const& GetInternal(const std::string& key);
   Def const& SetInternal(const std::string& key, Def const& def);
 
-  // Implementation of Closure() method.
-  struct ClosureTag {};
-  cmDefinitions(ClosureTag const&, cmDefinitions const* root);
-  void ClosureImpl(std::set<std::string>& undefined,
-                   cmDefinitions const* defs);
-
-  // Implementation of ClosureKeys() method.
+  // Implementation of LocalKeys() and ClosureKeys() methods.
+  static void CollectKeys(MapType const& map,
+                          std::set<std::string>& defined,
+                          std::set<std::string>& undefined);
   void ClosureKeys(std::set<std::string>& defined,
                    std::set<std::string>& undefined) const;
 };
@@ -24,6 +24,7 @@ cmDepends::cmDepends(cmLocalGenerator* lg, const char* targetDir):
   CompileDirectory(),
   LocalGenerator(lg),
   Verbose(false),
+  RescanNewerDependees(false),
   FileComparison(0),
   TargetDirectory(targetDir),
   MaxPath(16384),
@@ -197,7 +198,11 @@ bool cmDepends::CheckDependencies(std::istream& internalDepends,
     // * if the depender exists and is older than the dependee.
     // * if the depender does not exist, but the dependee is newer than the
     //   depends file
+    // * if the depender exists, but the dependee is newer than the depends
+    //   file and dependencies are checked in batch; the depender itself
+    //   need not be rebuilt
     bool regenerate = false;
+    bool rescan = false;
     const char* dependee = this->Dependee+1;
     const char* depender = this->Depender;
     if (currentDependencies != 0)
@@ -242,6 +247,26 @@ bool cmDepends::CheckDependencies(std::istream& internalDepends,
             cmSystemTools::Stdout(msg.str().c_str());
             }
           }
+        else if(this->RescanNewerDependees &&
+                (!this->FileComparison->FileTimeCompare(
+                   internalDependsFileName, dependee, &result) || result < 0))
+          {
+          // The dependee changed after the dependencies were scanned,
+          // but the depender was already rebuilt.  This happens when a
+          // generated file is regenerated after the scan.  Its own
+          // dependencies may have changed so scan it again.
+          rescan = true;
+
+          // Print verbose output.
+          if(this->Verbose)
+            {
+            std::ostringstream msg;
+            msg << "Dependee \"" << dependee
+                << "\" is newer than depends file \""
+                << internalDependsFileName << "\"." << std::endl;
+            cmSystemTools::Stdout(msg.str().c_str());
+            }
+          }
         }
       else
         {
@@ -266,7 +291,7 @@ bool cmDepends::CheckDependencies(std::istream& internalDepends,
           }
         }
       }
-    if(regenerate)
+    if(regenerate || rescan)
       {
       // Dependencies must be regenerated.
       okay = false;
@@ -280,7 +305,7 @@ bool cmDepends::CheckDependencies(std::istream& internalDepends,
         }
 
       // Remove the depender to be sure it is rebuilt.
-      if (dependerExists)
+      if (regenerate && dependerExists)
         {
         cmSystemTools::RemoveFile(depender);
         dependerExists = false;
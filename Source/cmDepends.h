@@ -49,6 +49,12 @@ public:
   /** should this be verbose in its output */
   void SetVerbose(bool verb) { this->Verbose = verb; }
 
+  /** Whether to rescan a depender that is up to date but has a
+      dependee newer than the dependencies, as happens when the scan
+      was skipped while its generated dependees were regenerated.  */
+  void SetRescanNewerDependees(bool rescan)
+    { this->RescanNewerDependees = rescan; }
+
   /** Virtual destructor to cleanup subclasses properly.  */
   virtual ~cmDepends();
 
@@ -100,6 +106,7 @@ protected:
 
   // Flag for verbose output.
   bool Verbose;
+  bool RescanNewerDependees;
   cmFileTimeComparison* FileComparison;
 
   std::string Language;
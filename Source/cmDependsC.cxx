@@ -15,14 +15,21 @@
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
 #include "cmSystemTools.h"
+#include "cmake.h"
 #include <cmsys/FStream.hxx>
 
 #include <ctype.h> // isspace
+#include <stdlib.h> // atol
+#include <string.h> // memchr
+#include <time.h>
 
 
+// Syntax of the include directives recognized by the scanner.  It is
+// matched by cmDependsCMatchInclude and recorded in the include cache.
 #define INCLUDE_REGEX_LINE \
   "^[ \t]*#[ \t]*(include|import)[ \t]*[<\"]([^\">]+)([\">])"
 
+#define INCLUDE_CACHE_FORMAT_MARKER "#IncludeCacheFormat: 2"
 #define INCLUDE_REGEX_LINE_MARKER "#IncludeRegexLine: "
 #define INCLUDE_REGEX_SCAN_MARKER "#IncludeRegexScan: "
 #define INCLUDE_REGEX_COMPLAIN_MARKER "#IncludeRegexComplain: "
@@ -31,6 +38,9 @@
 //----------------------------------------------------------------------------
 cmDependsC::cmDependsC()
 : ValidDeps(0)
+, UseCompilerDepends(false)
+, CacheModified(false)
+, CacheRewrite(false)
 {
 }
 
@@ -41,9 +51,16 @@ cmDependsC::cmDependsC(cmLocalGenerator* lg,
                    const std::map<std::string, DependencyVector>* validDeps)
 : cmDepends(lg, targetDir)
 , ValidDeps(validDeps)
+, UseCompilerDepends(false)
+, CacheModified(false)
+, CacheRewrite(false)
 {
   cmMakefile* mf = lg->GetMakefile();
 
+  // Check whether the compiler writes the dependencies.
+  this->UseCompilerDepends =
+    mf->IsOn("CMAKE_DEPENDS_USE_COMPILER_" + lang);
+
   // Configure the include file search path.
   this->SetIncludePathFromLanguage(lang);
 
@@ -67,7 +84,6 @@ cmDependsC::cmDependsC(cmLocalGenerator* lg,
     }
   }
 
-  this->IncludeRegexLine.compile(INCLUDE_REGEX_LINE);
   this->IncludeRegexScan.compile(scanRegex.c_str());
   this->IncludeRegexComplain.compile(complainRegex.c_str());
   this->IncludeRegexLineString = INCLUDE_REGEX_LINE_MARKER INCLUDE_REGEX_LINE;
@@ -78,18 +94,35 @@ cmDependsC::cmDependsC(cmLocalGenerator* lg,
 
   this->SetupTransforms();
 
-  this->CacheFileName = this->TargetDirectory;
+  // Headers are usually included by many targets so share the cache
+  // of their scanned include lines among the whole build tree.
+  this->CacheFileName = mf->GetHomeOutputDirectory();
+  this->CacheFileName += cmake::GetCMakeFilesDirectory();
   this->CacheFileName += "/";
   this->CacheFileName += lang;
   this->CacheFileName += ".includecache";
-
-  this->ReadCacheFile();
+  if(!this->ReadCacheFile())
+    {
+    // The shared cache was written with other regular expressions.
+    this->CacheFileName = this->TargetDirectory;
+    this->CacheFileName += "/";
+    this->CacheFileName += lang;
+    this->CacheFileName += ".includecache";
+    this->CacheModified = !this->ReadCacheFile();
+    }
 }
 
 //----------------------------------------------------------------------------
 cmDependsC::~cmDependsC()
 {
-  this->WriteCacheFile();
+  if(this->CacheRewrite)
+    {
+    this->WriteCacheFile();
+    }
+  else if(this->CacheModified)
+    {
+    this->AppendCacheFile();
+    }
   cmDeleteAll(this->FileCache);
 }
 
@@ -114,7 +147,14 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
   std::set<std::string> dependencies;
   bool haveDeps = false;
 
-  if (this->ValidDeps != 0)
+  // Use the dependencies written by the compiler when it last built
+  // the object file, if it did.
+  if (this->UseCompilerDepends)
+    {
+    haveDeps = this->ReadDepfile(obj + ".d", dependencies);
+    }
+
+  if (!haveDeps && this->ValidDeps != 0)
     {
     std::map<std::string, DependencyVector>::const_iterator tmpIt =
                                                     this->ValidDeps->find(obj);
@@ -217,9 +257,9 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
         // Check whether this file is already in the cache
         std::map<std::string, cmIncludeLines*>::iterator fileIt=
           this->FileCache.find(fullName);
-        if (fileIt!=this->FileCache.end())
+        if (fileIt!=this->FileCache.end() &&
+            this->CheckCacheEntry(fullName, fileIt->second))
           {
-          fileIt->second->Used=true;
           dependencies.insert(fullName);
           for (std::vector<UnscannedEntry>::const_iterator incIt=
                 fileIt->second->UnscannedEntries.begin();
@@ -283,23 +323,150 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
 }
 
 //----------------------------------------------------------------------------
-void cmDependsC::ReadCacheFile()
+bool cmDependsC::CheckDependencies(std::istream& internalDepends,
+                                   const char* internalDependsFileName,
+                            std::map<std::string, DependencyVector>& validDeps)
 {
+  bool okay = this->cmDepends::CheckDependencies(internalDepends,
+                                                 internalDependsFileName,
+                                                 validDeps);
+
+  // The compiler may have written new dependencies for a depender
+  // after they were last read, possibly within the same file time
+  // resolution.  They must be read again, but the depender need not
+  // be rebuilt.
+  for(std::map<std::string, DependencyVector>::iterator
+        i = validDeps.begin(); i != validDeps.end();)
+    {
+    std::string depfile = i->first + ".d";
+    int result = 0;
+    if(this->FileComparison->FileTimeCompare(internalDependsFileName,
+                                             depfile.c_str(), &result) &&
+       result <= 0)
+      {
+      okay = false;
+
+      // Print verbose output.
+      if(this->Verbose)
+        {
+        std::ostringstream msg;
+        msg << "Dependency file \"" << depfile
+            << "\" is not older than depends file \""
+            << internalDependsFileName << "\"." << std::endl;
+        cmSystemTools::Stdout(msg.str().c_str());
+        }
+      validDeps.erase(i++);
+      }
+    else
+      {
+      ++i;
+      }
+    }
+  return okay;
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsC::ReadDepfile(const std::string& depfile,
+                             std::set<std::string>& dependencies)
+{
+  cmsys::ifstream fin(depfile.c_str());
+  if(!fin)
+    {
+    return false;
+    }
+
+  // The file holds a make rule whose target is the object file and
+  // whose dependencies may continue over lines ending in a backslash.
+  // Spaces and '#' in file names are escaped by a backslash.  Relative
+  // paths are relative to the directory in which the compiler ran.
+  std::string dir =
+    this->LocalGenerator->GetMakefile()->GetStartOutputDirectory();
+  bool haveTarget = false;
+  std::string line;
+  std::string name;
+  while(cmSystemTools::GetLineFromStream(fin, line))
+    {
+    std::string::size_type end = line.size();
+    if(end > 0 && line[end-1] == '\\')
+      {
+      --end;
+      }
+    for(std::string::size_type i = 0; i <= end; ++i)
+      {
+      if(i < end && line[i] == '\\' && i+1 < end &&
+         (line[i+1] == ' ' || line[i+1] == '#'))
+        {
+        name += line[++i];
+        }
+      else if(i < end && line[i] == '$' && i+1 < end && line[i+1] == '$')
+        {
+        name += line[++i];
+        }
+      else if(i < end && line[i] != ' ' && line[i] != '\t')
+        {
+        name += line[i];
+        }
+      else if(!name.empty())
+        {
+        // Names ending in ':' are rule targets.  The first rule lists
+        // the dependencies, any others are phony rules for headers.
+        if(name[name.size()-1] == ':')
+          {
+          haveTarget = true;
+          }
+        else if(haveTarget)
+          {
+          name = cmSystemTools::CollapseFullPath(name, dir);
+          // A dependency removed since the object was built must not
+          // appear in the rules, the object will be rebuilt anyway.
+          if(cmSystemTools::FileExists(name.c_str(), true))
+            {
+            dependencies.insert(name);
+            }
+          }
+        name = "";
+        }
+      }
+    }
+  return haveTarget;
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsC::CheckCacheEntry(const std::string& fullName,
+                                 cmIncludeLines* entry)
+{
+  // The cache may have been written by another target long ago.  Check
+  // once per run that the file has not changed since it was scanned.
+  if(!entry->Checked)
+    {
+    entry->Checked = (entry->MTime != 0 &&
+                      cmSystemTools::ModifiedTime(fullName) == entry->MTime);
+    }
+  return entry->Checked;
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsC::ReadCacheFile()
+{
+  this->CacheRewrite = true;
   if(this->CacheFileName.empty())
     {
-    return;
+    return true;
     }
   cmsys::ifstream fin(this->CacheFileName.c_str());
   if(!fin)
     {
-    return;
+    return true;
     }
 
   std::string line;
   cmIncludeLines* cacheEntry=0;
   bool haveFileName=false;
+  bool haveFormat=false;
+  bool okay=true;
+  size_t records=0;
 
-  while(cmSystemTools::GetLineFromStream(fin, line))
+  while(okay && cmSystemTools::GetLineFromStream(fin, line))
     {
     if (line.empty())
       {
@@ -311,47 +478,43 @@ void cmDependsC::ReadCacheFile()
     if (haveFileName==false)
       {
       haveFileName=true;
-      int newer=0;
-      cmFileTimeComparison comp;
-      bool res=comp.FileTimeCompare(this->CacheFileName.c_str(),
-                                    line.c_str(), &newer);
-
-      if ((res==true) && (newer==1)) //cache is newer than the parsed file
+      // check that the format and the regular expressions match
+      if (line.find(INCLUDE_CACHE_FORMAT_MARKER) == 0)
         {
-        cacheEntry=new cmIncludeLines;
-        this->FileCache[line]=cacheEntry;
+        haveFormat = true;
         }
-      // file doesn't exist, check that the regular expressions
-      // haven't changed
-      else if (res==false)
+      else if (!haveFormat)
         {
-        if (line.find(INCLUDE_REGEX_LINE_MARKER) == 0)
-          {
-          if (line != this->IncludeRegexLineString)
-            {
-            return;
-            }
-          }
-        else if (line.find(INCLUDE_REGEX_SCAN_MARKER) == 0)
-          {
-          if (line != this->IncludeRegexScanString)
-            {
-            return;
-            }
-          }
-        else if (line.find(INCLUDE_REGEX_COMPLAIN_MARKER) == 0)
-          {
-          if (line != this->IncludeRegexComplainString)
-            {
-            return;
-            }
-          }
-        else if (line.find(INCLUDE_REGEX_TRANSFORM_MARKER) == 0)
+        okay = false;
+        }
+      else if (line.find(INCLUDE_REGEX_LINE_MARKER) == 0)
+        {
+        okay = (line == this->IncludeRegexLineString);
+        }
+      else if (line.find(INCLUDE_REGEX_SCAN_MARKER) == 0)
+        {
+        okay = (line == this->IncludeRegexScanString);
+        }
+      else if (line.find(INCLUDE_REGEX_COMPLAIN_MARKER) == 0)
+        {
+        okay = (line == this->IncludeRegexComplainString);
+        }
+      else if (line.find(INCLUDE_REGEX_TRANSFORM_MARKER) == 0)
+        {
+        okay = (line == this->IncludeRegexTransformString);
+        }
+      else
+        {
+        // the next line is the modification time of the parsed file
+        std::string mtime;
+        if (cmSystemTools::GetLineFromStream(fin, mtime))
           {
-          if (line != this->IncludeRegexTransformString)
-            {
-            return;
-            }
+          // A later entry for the same file supersedes earlier ones.
+          cacheEntry=new cmIncludeLines;
+          cacheEntry->MTime=atol(mtime.c_str());
+          delete this->FileCache[line];
+          this->FileCache[line]=cacheEntry;
+          ++records;
           }
         }
       }
@@ -369,6 +532,45 @@ void cmDependsC::ReadCacheFile()
         }
       }
     }
+
+  if (!okay)
+    {
+    cmDeleteAll(this->FileCache);
+    this->FileCache.clear();
+    return false;
+    }
+
+  // Runs append the entries they scan, so the file accumulates entries
+  // that were superseded, and entries of files that no longer exist.
+  // Compact it once it has grown to twice the number of files it
+  // lists, so that the cost of checking every file is spread over the
+  // runs that appended since the last time.
+  this->CacheRewrite = (!haveFormat ||
+                        records >= 2 * this->FileCache.size());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+static void cmDependsCWriteCacheEntry(std::ostream& os,
+                                      std::string const& fileName,
+                                      cmDependsC::cmIncludeLines const* entry)
+{
+  os << fileName << "\n" << entry->MTime << "\n";
+  for (std::vector<cmDependsC::UnscannedEntry>::const_iterator
+         incIt=entry->UnscannedEntries.begin();
+       incIt!=entry->UnscannedEntries.end(); ++incIt)
+    {
+    os << incIt->FileName << "\n";
+    if (incIt->QuotedLocation.empty())
+      {
+      os << "-\n";
+      }
+    else
+      {
+      os << incIt->QuotedLocation << "\n";
+      }
+    }
+  os << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -378,70 +580,217 @@ void cmDependsC::WriteCacheFile() const
     {
     return;
     }
-  cmsys::ofstream cacheOut(this->CacheFileName.c_str());
+
+  // Other scanners may read or write the cache concurrently.  Write a
+  // temporary file and rename it so that they never see a partial
+  // cache.  Entries appended by a concurrent scanner meanwhile are
+  // lost, in which case their files are simply scanned again.
+  std::ostringstream tmpName;
+  tmpName << this->CacheFileName << "." << cmSystemTools::RandomSeed()
+          << ".tmp";
+  std::string const& tmpFileName = tmpName.str();
+  {
+  cmsys::ofstream cacheOut(tmpFileName.c_str());
   if(!cacheOut)
     {
     return;
     }
 
+  cacheOut << INCLUDE_CACHE_FORMAT_MARKER << "\n\n";
   cacheOut << this->IncludeRegexLineString << "\n\n";
   cacheOut << this->IncludeRegexScanString << "\n\n";
   cacheOut << this->IncludeRegexComplainString << "\n\n";
   cacheOut << this->IncludeRegexTransformString << "\n\n";
 
+  // Drop the entries of files that were removed or changed since they
+  // were scanned so that the shared cache does not grow without bound.
+  // Files looked up during this run are already known to be unchanged.
   for (std::map<std::string, cmIncludeLines*>::const_iterator fileIt=
          this->FileCache.begin();
        fileIt!=this->FileCache.end(); ++fileIt)
     {
-    if (fileIt->second->Used)
+    cmIncludeLines const* entry = fileIt->second;
+    if (entry->MTime != 0 &&
+        (entry->Checked ||
+         cmSystemTools::ModifiedTime(fileIt->first) == entry->MTime))
       {
-      cacheOut<<fileIt->first.c_str()<<std::endl;
+      cmDependsCWriteCacheEntry(cacheOut, fileIt->first, entry);
+      }
+    }
+  if(!cacheOut.flush())
+    {
+    cacheOut.close();
+    cmSystemTools::RemoveFile(tmpFileName);
+    return;
+    }
+  }
+  if(!cmSystemTools::RenameFile(tmpFileName.c_str(),
+                                this->CacheFileName.c_str()))
+    {
+    cmSystemTools::RemoveFile(tmpFileName);
+    }
+}
 
-      for (std::vector<UnscannedEntry>::const_iterator
-             incIt=fileIt->second->UnscannedEntries.begin();
-           incIt!=fileIt->second->UnscannedEntries.end(); ++incIt)
-        {
-        cacheOut<<incIt->FileName.c_str()<<std::endl;
-        if (incIt->QuotedLocation.empty())
-          {
-          cacheOut<<"-"<<std::endl;
-          }
-        else
-          {
-          cacheOut<<incIt->QuotedLocation.c_str()<<std::endl;
-          }
-        }
-      cacheOut<<std::endl;
+//----------------------------------------------------------------------------
+void cmDependsC::AppendCacheFile() const
+{
+  if(this->CacheFileName.empty())
+    {
+    return;
+    }
+
+  // Append only the entries of the files scanned during this run.
+  // They supersede any earlier entries for the same files when the
+  // cache is read.  Write them with a single call so that concurrent
+  // scanners append their entries side by side instead of replacing
+  // each other's.
+  std::ostringstream entries;
+  for (std::map<std::string, cmIncludeLines*>::const_iterator fileIt=
+         this->FileCache.begin();
+       fileIt!=this->FileCache.end(); ++fileIt)
+    {
+    cmIncludeLines const* entry = fileIt->second;
+    if (entry->Scanned && entry->MTime != 0)
+      {
+      cmDependsCWriteCacheEntry(entries, fileIt->first, entry);
       }
-   }
+    }
+  std::string const& data = entries.str();
+  if(data.empty())
+    {
+    return;
+    }
+  cmsys::ofstream cacheOut(this->CacheFileName.c_str(),
+                           std::ios::out | std::ios::app);
+  if(cacheOut)
+    {
+    cacheOut.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+}
+
+//----------------------------------------------------------------------------
+static const char* cmDependsCSkipBlanks(const char* c, const char* end)
+{
+  while(c != end && (*c == ' ' || *c == '\t'))
+    {
+    ++c;
+    }
+  return c;
+}
+
+//----------------------------------------------------------------------------
+// Match the line [begin,end) against INCLUDE_REGEX_LINE.  On success
+// store the included file name and the character closing it.
+static bool cmDependsCMatchInclude(const char* begin, const char* end,
+                                   std::string& fileName, char& delimiter)
+{
+  const char* c = cmDependsCSkipBlanks(begin, end);
+  if(c == end || *c != '#')
+    {
+    return false;
+    }
+  c = cmDependsCSkipBlanks(c+1, end);
+  if(end-c >= 7 && strncmp(c, "include", 7) == 0)
+    {
+    c += 7;
+    }
+  else if(end-c >= 6 && strncmp(c, "import", 6) == 0)
+    {
+    c += 6;
+    }
+  else
+    {
+    return false;
+    }
+  c = cmDependsCSkipBlanks(c, end);
+  if(c == end || (*c != '<' && *c != '"'))
+    {
+    return false;
+    }
+  const char* name = ++c;
+  while(c != end && *c != '"' && *c != '>')
+    {
+    ++c;
+    }
+  if(c == end || c == name)
+    {
+    return false;
+    }
+  fileName.assign(name, c);
+  delimiter = *c;
+  return true;
 }
 
 //----------------------------------------------------------------------------
 void cmDependsC::Scan(std::istream& is, const char* directory,
   const std::string& fullName)
 {
+  // Record the modification time of the file unless it could still be
+  // changed within the same second without the cache noticing.
+  long now = static_cast<long>(time(0));
+  long mtime = cmSystemTools::ModifiedTime(fullName);
   cmIncludeLines* newCacheEntry=new cmIncludeLines;
-  newCacheEntry->Used=true;
+  newCacheEntry->MTime = mtime < now? mtime : 0;
+  newCacheEntry->Checked=true;
+  newCacheEntry->Scanned=true;
+  delete this->FileCache[fullName];
   this->FileCache[fullName]=newCacheEntry;
+  this->CacheModified=true;
 
-  // Read one line at a time.
+  // Read the whole file at once.
+  std::string content;
+  {
+  char buffer[16384];
+  while(is)
+    {
+    is.read(buffer, sizeof(buffer));
+    content.append(buffer, static_cast<std::string::size_type>(is.gcount()));
+    }
+  }
+
+  // Look at one line at a time.  Most lines cannot be directives so
+  // just search for the end of those without copying them.
   std::string line;
-  while(cmSystemTools::GetLineFromStream(is, line))
+  std::string fileName;
+  char delimiter;
+  const char* end = content.data() + content.size();
+  for(const char* begin = content.data(); begin != end;)
     {
-    // Transform the line content first.
-    if(!this->TransformRules.empty())
+    const char* eol = static_cast<const char*>(
+      memchr(begin, '\n', static_cast<size_t>(end - begin)));
+    const char* next = eol? eol + 1 : end;
+    if(!eol)
+      {
+      eol = end;
+      }
+
+    bool found;
+    if(this->TransformRules.empty())
       {
+      found = cmDependsCMatchInclude(begin, eol, fileName, delimiter);
+      }
+    else
+      {
+      // Transform the line content first.
+      line.assign(begin, eol);
+      if(!line.empty() && line[line.size()-1] == '\r')
+        {
+        line.resize(line.size()-1);
+        }
       this->TransformLine(line);
+      found = cmDependsCMatchInclude(line.data(), line.data() + line.size(),
+                                     fileName, delimiter);
       }
+    begin = next;
 
     // Match include directives.
-    if(this->IncludeRegexLine.find(line.c_str()))
+    if(found)
       {
       // Get the file being included.
       UnscannedEntry entry;
-      entry.FileName = this->IncludeRegexLine.match(2);
+      entry.FileName = fileName;
       cmSystemTools::ConvertToUnixSlashes(entry.FileName);
-      if(this->IncludeRegexLine.match(3) == "\"" &&
+      if(delimiter == '"' &&
          !cmSystemTools::FileIsFullPath(entry.FileName.c_str()))
         {
         // This was a double-quoted include with a relative path.  We
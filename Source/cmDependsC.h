@@ -38,14 +38,18 @@ protected:
                                  const std::string&           obj,
                                  std::ostream& makeDepends,
                                  std::ostream& internalDepends);
+  virtual bool CheckDependencies(std::istream& internalDepends,
+                                 const char* internalDependsFileName,
+                           std::map<std::string, DependencyVector>& validDeps);
+
+  // Method to read the dependencies written by the compiler.
+  bool ReadDepfile(const std::string& depfile,
+                   std::set<std::string>& dependencies);
 
   // Method to scan a single file.
   void Scan(std::istream& is, const char* directory,
     const std::string& fullName);
 
-  // Regular expression to identify C preprocessor include directives.
-  cmsys::RegularExpression IncludeRegexLine;
-
   // Regular expressions to choose which include files to scan
   // recursively and which to complain about not finding.
   cmsys::RegularExpression IncludeRegexScan;
@@ -73,22 +77,42 @@ public:
 
   struct cmIncludeLines
   {
-    cmIncludeLines(): Used(false) {}
+    cmIncludeLines(): MTime(0), Checked(false), Scanned(false) {}
     std::vector<UnscannedEntry> UnscannedEntries;
-    bool Used;
+    // Modification time of the file when it was scanned, or 0 if the
+    // file may have changed while it was scanned.
+    long MTime;
+    // Whether the file is known to be unchanged since it was scanned.
+    bool Checked;
+    // Whether the file was scanned during this run.
+    bool Scanned;
   };
 protected:
   const std::map<std::string, DependencyVector>* ValidDeps;
+
+  // Whether the compiler writes the dependencies of the object files.
+  bool UseCompilerDepends;
+
   std::set<std::string> Encountered;
   std::queue<UnscannedEntry> Unscanned;
 
   std::map<std::string, cmIncludeLines *> FileCache;
   std::map<std::string, std::string> HeaderLocationCache;
 
+  // The include cache is shared by all targets of the build tree whose
+  // regular expressions match those of the cache file.  Other targets
+  // use a cache file in their own directory.
   std::string CacheFileName;
+  bool CacheModified;
+
+  // Whether the cache file must be written as a whole instead of only
+  // appending the entries scanned during this run.
+  bool CacheRewrite;
 
+  bool CheckCacheEntry(const std::string& fullName, cmIncludeLines* entry);
   void WriteCacheFile() const;
-  void ReadCacheFile();
+  void AppendCacheFile() const;
+  bool ReadCacheFile();
 private:
   cmDependsC(cmDependsC const&); // Purposely not implemented.
   void operator=(cmDependsC const&); // Purposely not implemented.
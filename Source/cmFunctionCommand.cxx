@@ -13,14 +13,32 @@
 
 #include "cmake.h"
 
+// The recorded definition of a function.  It is shared by the command
+// prototype and every clone invoked from it and is never modified after
+// the function is defined.  The last command referencing it frees it.
+struct cmFunctionHelperBody
+{
+  cmFunctionHelperBody(): RefCount(1) {}
+  unsigned int RefCount;
+  std::vector<std::string> Args;
+  std::vector<cmListFileFunction> Functions;
+  cmPolicies::PolicyMap Policies;
+};
+
 // define the class for function commands
 class cmFunctionHelperCommand : public cmCommand
 {
 public:
-  cmFunctionHelperCommand() {}
+  cmFunctionHelperCommand(cmFunctionHelperBody* body): Body(body) {}
 
   ///! clean up any memory allocated by the function
-  ~cmFunctionHelperCommand() {}
+  ~cmFunctionHelperCommand()
+    {
+    if(--this->Body->RefCount == 0)
+      {
+      delete this->Body;
+      }
+    }
 
   /**
    * This is used to avoid including this command
@@ -38,12 +56,10 @@ public:
    */
   virtual cmCommand* Clone()
   {
-    cmFunctionHelperCommand *newC = new cmFunctionHelperCommand;
-    // we must copy when we clone
-    newC->Args = this->Args;
-    newC->Functions = this->Functions;
-    newC->Policies = this->Policies;
-    return newC;
+    // The clone shares the body so that it stays alive even if the
+    // function is redefined while it is executing.
+    ++this->Body->RefCount;
+    return new cmFunctionHelperCommand(this->Body);
   }
 
   /**
@@ -64,13 +80,12 @@ public:
   /**
    * The name of the command as specified in CMakeList.txt.
    */
-  virtual std::string GetName() const { return this->Args[0]; }
+  virtual std::string GetName() const { return this->Body->Args[0]; }
 
   cmTypeMacro(cmFunctionHelperCommand, cmCommand);
 
-  std::vector<std::string> Args;
-  std::vector<cmListFileFunction> Functions;
-  cmPolicies::PolicyMap Policies;
+private:
+  cmFunctionHelperBody* Body;
 };
 
 
@@ -84,11 +99,11 @@ bool cmFunctionHelperCommand::InvokeInitialPass
 
   // make sure the number of arguments passed is at least the number
   // required by the signature
-  if (expandedArgs.size() < this->Args.size() - 1)
+  if (expandedArgs.size() < this->Body->Args.size() - 1)
     {
     std::string errorMsg =
       "Function invoked with incorrect arguments for function named: ";
-    errorMsg += this->Args[0];
+    errorMsg += this->Body->Args[0];
     this->SetError(errorMsg);
     return false;
     }
@@ -100,7 +115,8 @@ bool cmFunctionHelperCommand::InvokeInitialPass
 
   // Push a weak policy scope which restores the policies recorded at
   // function creation.
-  cmMakefile::PolicyPushPop polScope(this->Makefile, true, this->Policies);
+  cmMakefile::PolicyPushPop polScope(this->Makefile, true,
+                                     this->Body->Policies);
 
   // set the value of argc
   std::ostringstream strStream;
@@ -119,16 +135,16 @@ bool cmFunctionHelperCommand::InvokeInitialPass
     }
 
   // define the formal arguments
-  for (unsigned int j = 1; j < this->Args.size(); ++j)
+  for (unsigned int j = 1; j < this->Body->Args.size(); ++j)
     {
-    this->Makefile->AddDefinition(this->Args[j],
+    this->Makefile->AddDefinition(this->Body->Args[j],
                                   expandedArgs[j-1].c_str());
     }
 
   // define ARGV and ARGN
   std::string argvDef = cmJoin(expandedArgs, ";");
   std::vector<std::string>::const_iterator eit
-      = expandedArgs.begin() + (this->Args.size()-1);
+      = expandedArgs.begin() + (this->Body->Args.size()-1);
   std::string argnDef = cmJoin(cmRange(eit, expandedArgs.end()), ";");
   this->Makefile->AddDefinition("ARGV", argvDef.c_str());
   this->Makefile->MarkVariableAsUsed("ARGV");
@@ -137,10 +153,10 @@ bool cmFunctionHelperCommand::InvokeInitialPass
 
   // Invoke all the functions that were collected in the block.
   // for each function
-  for(unsigned int c = 0; c < this->Functions.size(); ++c)
+  for(unsigned int c = 0; c < this->Body->Functions.size(); ++c)
     {
     cmExecutionStatus status;
-    if (!this->Makefile->ExecuteCommand(this->Functions[c],status) ||
+    if (!this->Makefile->ExecuteCommand(this->Body->Functions[c],status) ||
         status.GetNestedError())
       {
       // The error message should have already included the call stack
@@ -176,21 +192,23 @@ IsFunctionBlocked(const cmListFileFunction& lff, cmMakefile &mf,
     if (!this->Depth)
       {
       // create a new command and add it to cmake
-      cmFunctionHelperCommand *f = new cmFunctionHelperCommand();
-      f->Args = this->Args;
-      f->Functions = this->Functions;
-      mf.RecordPolicies(f->Policies);
+      cmFunctionHelperBody *body = new cmFunctionHelperBody;
+      body->Args = this->Args;
+      body->Functions = this->Functions;
+      mf.RecordPolicies(body->Policies);
 
       // Set the FilePath on the arguments to match the function since it is
       // not stored and the original values may be freed
-      for (unsigned int i = 0; i < f->Functions.size(); ++i)
+      for (unsigned int i = 0; i < body->Functions.size(); ++i)
         {
-        for (unsigned int j = 0; j < f->Functions[i].Arguments.size(); ++j)
+        for (unsigned int j = 0; j < body->Functions[i].Arguments.size();
+             ++j)
           {
-          f->Functions[i].Arguments[j].FilePath =
-            f->Functions[i].FilePath.c_str();
+          body->Functions[i].Arguments[j].FilePath =
+            body->Functions[i].FilePath.c_str();
           }
         }
+      cmFunctionHelperCommand *f = new cmFunctionHelperCommand(body);
 
       std::string newName = "_" + this->Args[0];
       mf.GetCMakeInstance()->RenameCommand(this->Args[0],
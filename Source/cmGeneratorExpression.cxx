@@ -20,6 +20,66 @@
 #include "cmGeneratorExpressionParser.h"
 #include "cmGeneratorExpressionDAGChecker.h"
 
+//----------------------------------------------------------------------------
+// The evaluators parsed from one input string.  They are owned by a
+// process-wide table so that an expression appearing in many properties,
+// such as the usage requirements of a widely used imported target, is
+// lexed and parsed only once.
+struct cmGeneratorExpressionParseTree
+{
+  static cmGeneratorExpressionParseTree* Get(std::string const& input);
+
+  // The evaluators refer to the text of this copy of the input.
+  const std::string Input;
+  std::vector<cmGeneratorExpressionEvaluator*> Evaluators;
+
+  // Set once an evaluation has consulted nothing but the input.
+  bool HaveContextInsensitiveResult;
+  std::string ContextInsensitiveResult;
+
+private:
+  cmGeneratorExpressionParseTree(std::string const& input);
+  ~cmGeneratorExpressionParseTree() { cmDeleteAll(this->Evaluators); }
+  cmGeneratorExpressionParseTree(cmGeneratorExpressionParseTree const&);
+  void operator=(cmGeneratorExpressionParseTree const&);
+
+  struct Table: public std::map<std::string, cmGeneratorExpressionParseTree*>
+  {
+    ~Table()
+      {
+      for(iterator i = this->begin(); i != this->end(); ++i)
+        {
+        delete i->second;
+        }
+      }
+  };
+};
+
+//----------------------------------------------------------------------------
+cmGeneratorExpressionParseTree
+::cmGeneratorExpressionParseTree(std::string const& input):
+  Input(input), HaveContextInsensitiveResult(false)
+{
+  cmGeneratorExpressionLexer l;
+  std::vector<cmGeneratorExpressionToken> tokens = l.Tokenize(this->Input);
+  cmGeneratorExpressionParser p(tokens);
+  p.Parse(this->Evaluators);
+}
+
+//----------------------------------------------------------------------------
+cmGeneratorExpressionParseTree*
+cmGeneratorExpressionParseTree::Get(std::string const& input)
+{
+  static Table table;
+  Table::iterator i = table.lower_bound(input);
+  if(i == table.end() || i->first != input)
+    {
+    i = table.insert(i, Table::value_type(input,
+                            new cmGeneratorExpressionParseTree(input)));
+    }
+  return i->second;
+}
+
 //----------------------------------------------------------------------------
 cmGeneratorExpression::cmGeneratorExpression(
   cmListFileBacktrace const* backtrace):
@@ -72,17 +132,31 @@ const char *cmCompiledGeneratorExpression::Evaluate(
   cmGeneratorExpressionDAGChecker *dagChecker,
   std::string const& language) const
 {
-  if (!this->NeedsEvaluation)
+  this->HadError = false;
+  if (!this->Tree)
     {
     return this->Input.c_str();
     }
 
+  if (this->Tree->HaveContextInsensitiveResult)
+    {
+    this->Output = this->Tree->ContextInsensitiveResult;
+    this->SeenTargetProperties.clear();
+    this->MaxLanguageStandard.clear();
+    this->HadContextSensitiveCondition = false;
+    this->HadHeadSensitiveCondition = false;
+    this->SourceSensitiveTargets.clear();
+    this->DependTargets.clear();
+    this->AllTargetsSeen.clear();
+    return this->Output.c_str();
+    }
+
   this->Output = "";
 
   std::vector<cmGeneratorExpressionEvaluator*>::const_iterator it
-                                                  = this->Evaluators.begin();
+                                            = this->Tree->Evaluators.begin();
   const std::vector<cmGeneratorExpressionEvaluator*>::const_iterator end
-                                                  = this->Evaluators.end();
+                                            = this->Tree->Evaluators.end();
 
   cmGeneratorExpressionContext context;
   context.Makefile = mf;
@@ -91,6 +165,7 @@ const char *cmCompiledGeneratorExpression::Evaluate(
   context.HadError = false;
   context.HadContextSensitiveCondition = false;
   context.HadHeadSensitiveCondition = false;
+  context.HadContextDependentNode = false;
   context.SourceSensitiveTargets.clear();
   context.HeadTarget = headTarget;
   context.EvaluateForBuildsystem = this->EvaluateForBuildsystem;
@@ -112,6 +187,7 @@ const char *cmCompiledGeneratorExpression::Evaluate(
     }
 
   this->MaxLanguageStandard = context.MaxLanguageStandard;
+  this->HadError = context.HadError;
 
   if (!context.HadError)
     {
@@ -122,6 +198,14 @@ const char *cmCompiledGeneratorExpression::Evaluate(
 
   this->DependTargets = context.DependTargets;
   this->AllTargetsSeen = context.AllTargets;
+
+  if (!context.HadError && !context.HadContextDependentNode)
+    {
+    // Only the input was consulted, so every later evaluation of the
+    // same input produces the same result.
+    this->Tree->HaveContextInsensitiveResult = true;
+    this->Tree->ContextInsensitiveResult = this->Output;
+    }
   // TODO: Return a std::string from here instead?
   return this->Output.c_str();
 }
@@ -129,20 +213,15 @@ const char *cmCompiledGeneratorExpression::Evaluate(
 cmCompiledGeneratorExpression::cmCompiledGeneratorExpression(
               cmListFileBacktrace const& backtrace,
               const std::string& input)
-  : Backtrace(backtrace), Input(input),
+  : Backtrace(backtrace), Tree(0), Input(input),
+    HadError(false),
     HadContextSensitiveCondition(false),
     HadHeadSensitiveCondition(false),
     EvaluateForBuildsystem(false)
 {
-  cmGeneratorExpressionLexer l;
-  std::vector<cmGeneratorExpressionToken> tokens =
-                                              l.Tokenize(this->Input);
-  this->NeedsEvaluation = l.GetSawGeneratorExpression();
-
-  if (this->NeedsEvaluation)
+  if (cmGeneratorExpression::Find(this->Input) != std::string::npos)
     {
-    cmGeneratorExpressionParser p(tokens);
-    p.Parse(this->Evaluators);
+    this->Tree = cmGeneratorExpressionParseTree::Get(this->Input);
     }
 }
 
@@ -150,7 +229,6 @@ cmCompiledGeneratorExpression::cmCompiledGeneratorExpression(
 //----------------------------------------------------------------------------
 cmCompiledGeneratorExpression::~cmCompiledGeneratorExpression()
 {
-  cmDeleteAll(this->Evaluators);
 }
 
 //----------------------------------------------------------------------------
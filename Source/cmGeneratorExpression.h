@@ -25,6 +25,7 @@ class cmListFileBacktrace;
 
 struct cmGeneratorExpressionEvaluator;
 struct cmGeneratorExpressionDAGChecker;
+struct cmGeneratorExpressionParseTree;
 
 class cmCompiledGeneratorExpression;
 
@@ -109,6 +110,10 @@ public:
   {
     return this->Backtrace;
   }
+  bool GetHadError() const
+  {
+    return this->HadError;
+  }
   bool GetHadContextSensitiveCondition() const
   {
     return this->HadContextSensitiveCondition;
@@ -140,9 +145,10 @@ private:
   void operator=(const cmCompiledGeneratorExpression &);
 
   cmListFileBacktrace Backtrace;
-  std::vector<cmGeneratorExpressionEvaluator*> Evaluators;
+  // The parsed form of the input, shared by all expressions with the
+  // same input.  It is null if the input contains no expressions.
+  cmGeneratorExpressionParseTree* Tree;
   const std::string Input;
-  bool NeedsEvaluation;
 
   mutable std::set<cmTarget*> DependTargets;
   mutable std::set<cmTarget const*> AllTargetsSeen;
@@ -150,6 +156,7 @@ private:
   mutable std::map<cmTarget const*, std::map<std::string, std::string> >
                                                           MaxLanguageStandard;
   mutable std::string Output;
+  mutable bool HadError;
   mutable bool HadContextSensitiveCondition;
   mutable bool HadHeadSensitiveCondition;
   mutable std::set<cmTarget const*>  SourceSensitiveTargets;
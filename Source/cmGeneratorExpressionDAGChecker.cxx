@@ -209,6 +209,22 @@ std::string cmGeneratorExpressionDAGChecker::TopTarget() const
   return top->Target;
 }
 
+//----------------------------------------------------------------------------
+bool cmGeneratorExpressionDAGChecker
+::SawPropertyOnTarget(std::string const& property) const
+{
+  for (std::map<std::string, std::set<std::string> >::const_iterator it
+       = this->Seen.begin(); it != this->Seen.end(); ++it)
+    {
+    if (it->first != this->Target
+        && it->second.find(property) != it->second.end())
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
 enum TransitiveProperty {
 #define DEFINE_ENUM_ENTRY(NAME) NAME,
   CM_FOR_EACH_TRANSITIVE_PROPERTY_NAME(DEFINE_ENUM_ENTRY)
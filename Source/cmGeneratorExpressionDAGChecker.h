@@ -78,6 +78,10 @@ struct cmGeneratorExpressionDAGChecker
 
   std::string TopTarget() const;
 
+  /** Whether the given property of a target other than the one named by
+      this top-level checker was read beneath it.  */
+  bool SawPropertyOnTarget(std::string const& property) const;
+
 private:
   Result CheckGraph() const;
   void Initialize();
@@ -62,6 +62,9 @@ struct cmGeneratorExpressionNode
 
   virtual int NumExpectedParameters() const { return 1; }
 
+  // Whether the result depends on anything besides the parameters.
+  virtual bool DependsOnContext() const { return true; }
+
   virtual std::string Evaluate(const std::vector<std::string> &parameters,
                                cmGeneratorExpressionContext *context,
                                const GeneratorExpressionContent *content,
@@ -92,6 +95,10 @@ std::string cmGeneratorExpressionNode::EvaluateDependentExpression(
                         currentTarget,
                         dagChecker,
                         context->Language);
+  if (cge->GetHadError())
+    {
+    context->HadError = true;
+    }
   if (cge->GetHadContextSensitiveCondition())
     {
     context->HadContextSensitiveCondition = true;
@@ -108,6 +115,8 @@ static const struct ZeroNode : public cmGeneratorExpressionNode
 {
   ZeroNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   virtual bool GeneratesContent() const { return false; }
 
   virtual bool AcceptsArbitraryContentParameter() const { return true; }
@@ -126,6 +135,8 @@ static const struct OneNode : public cmGeneratorExpressionNode
 {
   OneNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   virtual bool AcceptsArbitraryContentParameter() const { return true; }
 
   std::string Evaluate(const std::vector<std::string> &parameters,
@@ -148,6 +159,7 @@ static const struct ZeroNode installInterfaceNode;
 static const struct OP ## Node : public cmGeneratorExpressionNode \
 { \
   OP ## Node () {} \
+  virtual bool DependsOnContext() const { return false; } \
   virtual int NumExpectedParameters() const { return OneOrMoreParameters; } \
  \
   std::string Evaluate(const std::vector<std::string> &parameters, \
@@ -184,6 +196,8 @@ static const struct NotNode : public cmGeneratorExpressionNode
 {
   NotNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   std::string Evaluate(const std::vector<std::string> &parameters,
                        cmGeneratorExpressionContext *context,
                        const GeneratorExpressionContent *content,
@@ -204,6 +218,8 @@ static const struct BoolNode : public cmGeneratorExpressionNode
 {
   BoolNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   virtual int NumExpectedParameters() const { return 1; }
 
   std::string Evaluate(const std::vector<std::string> &parameters,
@@ -220,6 +236,8 @@ static const struct StrEqualNode : public cmGeneratorExpressionNode
 {
   StrEqualNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   virtual int NumExpectedParameters() const { return 2; }
 
   std::string Evaluate(const std::vector<std::string> &parameters,
@@ -236,6 +254,8 @@ static const struct EqualNode : public cmGeneratorExpressionNode
 {
   EqualNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   virtual int NumExpectedParameters() const { return 2; }
 
   std::string Evaluate(const std::vector<std::string> &parameters,
@@ -322,6 +342,8 @@ static const struct LowerCaseNode : public cmGeneratorExpressionNode
 {
   LowerCaseNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   bool AcceptsArbitraryContentParameter() const { return true; }
 
   std::string Evaluate(const std::vector<std::string> &parameters,
@@ -338,6 +360,8 @@ static const struct UpperCaseNode : public cmGeneratorExpressionNode
 {
   UpperCaseNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   bool AcceptsArbitraryContentParameter() const { return true; }
 
   std::string Evaluate(const std::vector<std::string> &parameters,
@@ -354,6 +378,8 @@ static const struct MakeCIdentifierNode : public cmGeneratorExpressionNode
 {
   MakeCIdentifierNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   bool AcceptsArbitraryContentParameter() const { return true; }
 
   std::string Evaluate(const std::vector<std::string> &parameters,
@@ -370,6 +396,8 @@ static const struct Angle_RNode : public cmGeneratorExpressionNode
 {
   Angle_RNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   virtual int NumExpectedParameters() const { return 0; }
 
   std::string Evaluate(const std::vector<std::string> &,
@@ -386,6 +414,8 @@ static const struct CommaNode : public cmGeneratorExpressionNode
 {
   CommaNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   virtual int NumExpectedParameters() const { return 0; }
 
   std::string Evaluate(const std::vector<std::string> &,
@@ -402,6 +432,8 @@ static const struct SemicolonNode : public cmGeneratorExpressionNode
 {
   SemicolonNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   virtual int NumExpectedParameters() const { return 0; }
 
   std::string Evaluate(const std::vector<std::string> &,
@@ -638,6 +670,8 @@ static const struct VersionGreaterNode : public cmGeneratorExpressionNode
 {
   VersionGreaterNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   virtual int NumExpectedParameters() const { return 2; }
 
   std::string Evaluate(const std::vector<std::string> &parameters,
@@ -656,6 +690,8 @@ static const struct VersionLessNode : public cmGeneratorExpressionNode
 {
   VersionLessNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   virtual int NumExpectedParameters() const { return 2; }
 
   std::string Evaluate(const std::vector<std::string> &parameters,
@@ -674,6 +710,8 @@ static const struct VersionEqualNode : public cmGeneratorExpressionNode
 {
   VersionEqualNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   virtual int NumExpectedParameters() const { return 2; }
 
   std::string Evaluate(const std::vector<std::string> &parameters,
@@ -793,6 +831,8 @@ static const struct JoinNode : public cmGeneratorExpressionNode
 {
   JoinNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   virtual int NumExpectedParameters() const { return 2; }
 
   virtual bool AcceptsArbitraryContentParameter() const { return true; }
@@ -1172,6 +1212,11 @@ static const struct TargetPropertyNode : public cmGeneratorExpressionNode
       if(cmTarget::LinkInterfaceLibraries const* iface =
          target->GetLinkInterfaceLibraries(context->Config, headTarget, true))
         {
+        if(iface->HadHeadSensitiveCondition)
+          {
+          // The content differs between head targets.
+          context->HadHeadSensitiveCondition = true;
+          }
         linkedTargetsContent =
           getLinkedTargetsContent(iface->Libraries, target,
                                   headTarget,
@@ -1285,6 +1330,8 @@ static const struct TargetNameNode : public cmGeneratorExpressionNode
 {
   TargetNameNode() {}
 
+  virtual bool DependsOnContext() const { return false; }
+
   virtual bool GeneratesContent() const { return true; }
 
   virtual bool AcceptsArbitraryContentParameter() const { return true; }
@@ -2009,6 +2056,11 @@ std::string GeneratorExpressionContent::Evaluate(
     return std::string();
     }
 
+  if (node->DependsOnContext())
+    {
+    context->HadContextDependentNode = true;
+    }
+
   if (!node->GeneratesContent())
     {
     if (node->NumExpectedParameters() == 1
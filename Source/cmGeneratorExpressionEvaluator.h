@@ -44,6 +44,7 @@ struct cmGeneratorExpressionContext
   bool HadError;
   bool HadContextSensitiveCondition;
   bool HadHeadSensitiveCondition;
+  bool HadContextDependentNode; // Some node consulted more than its input.
   bool EvaluateForBuildsystem;
 };
 
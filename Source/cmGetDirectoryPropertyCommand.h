@@ -34,6 +34,8 @@ public:
    */
   virtual bool IsScriptable() const { return true; }
 
+  virtual bool IsStateless() const { return true; }
+
   /**
    * The name of the command as specified in CMakeList.txt.
    */
@@ -1277,6 +1277,13 @@ void cmGlobalGenerator::Generate()
   // it builds by default.
   this->FillLocalGeneratorToTargetMap();
 
+  if(!this->LocalGenerators.empty() &&
+     this->LocalGenerators[0]->GetMakefile()
+       ->IsOn("CMAKE_GENERATE_PRECOMPUTE"))
+    {
+    this->PrecomputeGeneratorTargets();
+    }
+
   // Generate project files
   for (i = 0; i < this->LocalGenerators.size(); ++i)
     {
@@ -1361,6 +1368,85 @@ bool cmGlobalGenerator::ComputeTargetDepends()
   return true;
 }
 
+//----------------------------------------------------------------------------
+void cmGlobalGenerator::PrecomputeGeneratorTargets()
+{
+  // Target properties no longer change, so every directory may store
+  // the results computed below.
+  unsigned int i;
+  for (i = 0; i < this->LocalGenerators.size(); ++i)
+    {
+    this->LocalGenerators[i]->GetMakefile()->SetGeneratingBuildSystem();
+    }
+
+  for (i = 0; i < this->LocalGenerators.size(); ++i)
+    {
+    cmMakefile* mf = this->LocalGenerators[i]->GetMakefile();
+    this->SetCurrentLocalGenerator(this->LocalGenerators[i]);
+
+    // Use the configurations for which the local generator asks.
+    std::vector<std::string> configs;
+    mf->GetConfigurations(configs);
+    if (configs.empty())
+      {
+      configs.push_back("");
+      }
+
+    cmGeneratorTargetsType const& targets = mf->GetGeneratorTargets();
+    for(cmGeneratorTargetsType::const_iterator ti = targets.begin();
+        ti != targets.end(); ++ti)
+      {
+      cmGeneratorTarget* gt = ti->second;
+      cmTarget* target = gt->Target;
+      if(target->IsImported() ||
+         target->GetType() == cmTarget::INTERFACE_LIBRARY)
+        {
+        continue;
+        }
+
+      for(std::vector<std::string>::const_iterator ci = configs.begin();
+          ci != configs.end(); ++ci)
+        {
+        std::string const& config = *ci;
+        std::vector<cmSourceFile*> sources;
+        gt->GetSourceFiles(sources, config);
+
+        std::set<std::string> languages;
+        target->GetLanguages(languages, config);
+        for(std::set<std::string>::const_iterator li = languages.begin();
+            li != languages.end(); ++li)
+          {
+          std::vector<std::string> values;
+          target->GetIncludeDirectories(config, *li);
+          target->GetCompileDefinitions(values, config, *li);
+          target->GetCompileOptions(values, config, *li);
+          }
+        if(!languages.empty())
+          {
+          std::vector<std::string> features;
+          target->GetCompileFeatures(features, config);
+          }
+
+        if(target->GetType() == cmTarget::EXECUTABLE ||
+           target->GetType() == cmTarget::SHARED_LIBRARY ||
+           target->GetType() == cmTarget::MODULE_LIBRARY)
+          {
+          target->GetLinkInformation(config);
+          }
+        }
+
+      // Multi-configuration generators compute the object names from
+      // the sources of another configuration, so leave them alone.
+      if(!this->IsMultiConfig())
+        {
+        std::vector<cmSourceFile const*> objectSources;
+        gt->GetObjectSources(objectSources, configs[0]);
+        }
+      }
+    }
+  this->SetCurrentLocalGenerator(0);
+}
+
 //----------------------------------------------------------------------------
 void cmGlobalGenerator::CreateQtAutoGeneratorsTargets(AutogensType &autogens)
 {
@@ -23,6 +23,8 @@
 
 const char* cmGlobalNinjaGenerator::NINJA_BUILD_FILE = "build.ninja";
 const char* cmGlobalNinjaGenerator::NINJA_RULES_FILE = "rules.ninja";
+const char* cmGlobalNinjaGenerator::NINJA_DIRECTORY_BUILD_FILE =
+  "CMakeFiles/directory.ninja";
 const char* cmGlobalNinjaGenerator::INDENT = "  ";
 
 void cmGlobalNinjaGenerator::Indent(std::ostream& os, int count)
@@ -141,6 +143,8 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
 
   cmGlobalNinjaGenerator::WriteComment(os, comment);
 
+  // Assemble the statement in one string and write it at once.  Any
+  // variables EncodeIdent needs are written to the stream before it.
   std::string arguments;
 
   // TODO: Better formatting for when there are multiple input/output files.
@@ -150,7 +154,8 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
       i != explicitDeps.end();
       ++i)
     {
-    arguments += " " + EncodeIdent(EncodePath(*i), os);
+    arguments += " ";
+    arguments += EncodeIdent(EncodePath(*i), os);
     }
 
   // Write implicit dependencies.
@@ -160,7 +165,10 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
     for(cmNinjaDeps::const_iterator i = implicitDeps.begin();
         i != implicitDeps.end();
         ++i)
-      arguments += " " + EncodeIdent(EncodePath(*i), os);
+      {
+      arguments += " ";
+      arguments += EncodeIdent(EncodePath(*i), os);
+      }
     }
 
   // Write order-only dependencies.
@@ -170,7 +178,10 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
     for(cmNinjaDeps::const_iterator i = orderOnlyDeps.begin();
         i != orderOnlyDeps.end();
         ++i)
-      arguments += " " + EncodeIdent(EncodePath(*i), os);
+      {
+      arguments += " ";
+      arguments += EncodeIdent(EncodePath(*i), os);
+      }
     }
 
   arguments += "\n";
@@ -182,13 +193,16 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
   for(cmNinjaDeps::const_iterator i = outputs.begin();
       i != outputs.end(); ++i)
     {
-    build += " " + EncodeIdent(EncodePath(*i), os);
-    this->CombinedBuildOutputs.insert( EncodePath(*i) );
+    std::string path = EncodePath(*i);
+    build += " ";
+    build += EncodeIdent(path, os);
+    this->CombinedBuildOutputs.insert(path);
     }
   build += ":";
 
   // Write the rule.
-  build += " " + rule;
+  build += " ";
+  build += rule;
 
   // Write the variables bound to this build statement.
   std::ostringstream variable_assignments;
@@ -198,20 +212,20 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
                                           i->first, i->second, "", 1);
 
   // check if a response file rule should be used
-  std::string buildstr = build;
   std::string assignments = variable_assignments.str();
-  const std::string& args = arguments;
   if (cmdLineLimit > 0
-      && args.size() + buildstr.size() + assignments.size()
+      && arguments.size() + build.size() + assignments.size()
                                                     > (size_t) cmdLineLimit) {
-    buildstr += "_RSP_FILE";
+    build += "_RSP_FILE";
     variable_assignments.str(std::string());
     cmGlobalNinjaGenerator::WriteVariable(variable_assignments,
                                           "RSP_FILE", rspfile, "", 1);
     assignments += variable_assignments.str();
   }
 
-  os << buildstr << args << assignments;
+  build += arguments;
+  build += assignments;
+  os.write(build.data(), static_cast<std::streamsize>(build.size()));
 }
 
 void cmGlobalNinjaGenerator::WritePhonyBuild(std::ostream& os,
@@ -458,6 +472,14 @@ void cmGlobalNinjaGenerator::WriteInclude(std::ostream& os,
   os << "include " << filename << "\n";
 }
 
+void cmGlobalNinjaGenerator::WriteSubninja(std::ostream& os,
+                                           const std::string& filename,
+                                           const std::string& comment)
+{
+  cmGlobalNinjaGenerator::WriteComment(os, comment);
+  os << "subninja " << filename << "\n";
+}
+
 void cmGlobalNinjaGenerator::WriteDefault(std::ostream& os,
                                           const cmNinjaDeps& targets,
                                           const std::string& comment)
@@ -475,6 +497,7 @@ cmGlobalNinjaGenerator::cmGlobalNinjaGenerator()
   , BuildFileStream(0)
   , RulesFileStream(0)
   , CompileCommandsStream(0)
+  , UseDirectoryBuildFiles(false)
   , Rules()
   , AllDependencies()
 {
@@ -507,6 +530,10 @@ void cmGlobalNinjaGenerator
 //   Source/cmake.cxx
 void cmGlobalNinjaGenerator::Generate()
 {
+  this->UseDirectoryBuildFiles = !this->LocalGenerators.empty() &&
+    this->LocalGenerators[0]->GetMakefile()
+      ->IsOn("CMAKE_NINJA_DIRECTORY_BUILD_FILES");
+
   this->OpenBuildFileStream();
   this->OpenRulesFileStream();
 
@@ -702,6 +729,45 @@ void cmGlobalNinjaGenerator::OpenBuildFileStream()
     ;
 }
 
+cmGeneratedFileStream*
+cmGlobalNinjaGenerator::OpenDirectoryBuildFileStream(std::string const& dir)
+{
+  std::string buildFilePath = dir;
+  buildFilePath += "/";
+  buildFilePath += cmGlobalNinjaGenerator::NINJA_DIRECTORY_BUILD_FILE;
+
+  // Leave the file alone if its content does not change so that an
+  // unchanged directory costs no I/O beyond the comparison.
+  cmGeneratedFileStream* os =
+    new cmGeneratedFileStream(buildFilePath.c_str());
+  os->SetCopyIfDifferent(true);
+
+  // Write the do not edit header.
+  this->WriteDisclaimer(*os);
+
+  // Write a comment about this file.
+  *os
+    << "# This file contains the build statements of one directory.\n"
+    << "# It is included by the main '" << NINJA_BUILD_FILE << "'.\n\n"
+    ;
+  return os;
+}
+
+void cmGlobalNinjaGenerator
+::CloseDirectoryBuildFileStream(cmGeneratedFileStream* os,
+                                std::string const& path)
+{
+  if (cmSystemTools::GetErrorOccuredFlag())
+    {
+    os->setstate(std::ios_base::failbit);
+    }
+  delete os;
+
+  WriteSubninja(*this->BuildFileStream,
+                EncodeIdent(EncodePath(path), *this->BuildFileStream),
+                "Include build statements of one directory.");
+}
+
 void cmGlobalNinjaGenerator::CloseBuildFileStream()
 {
   if (this->BuildFileStream)
@@ -48,6 +48,10 @@ public:
   /// The default name of Ninja's build file. Typically: build.ninja.
   static const char* NINJA_BUILD_FILE;
 
+  /// The file holding the build statements of one directory, relative to
+  /// its build directory, when CMAKE_NINJA_DIRECTORY_BUILD_FILES is set.
+  static const char* NINJA_DIRECTORY_BUILD_FILE;
+
   /// The default name of Ninja's rules file. Typically: rules.ninja.
   /// It is included in the main build.ninja file.
   static const char* NINJA_RULES_FILE;
@@ -147,6 +151,14 @@ public:
                            const std::string& filename,
                            const std::string& comment = "");
 
+  /**
+   * Write a subninja statement including @a filename in its own scope
+   * with an optional @a comment to the @a os stream.
+   */
+  static void WriteSubninja(std::ostream& os,
+                            const std::string& filename,
+                            const std::string& comment = "");
+
   /**
    * Write a default target statement specifying @a targets as
    * the default targets.
@@ -229,6 +241,18 @@ public:
   cmGeneratedFileStream* GetRulesFileStream() const {
     return this->RulesFileStream; }
 
+  /// Whether each directory writes its build statements to its own file.
+  bool GetUseDirectoryBuildFiles() const {
+    return this->UseDirectoryBuildFiles; }
+
+  /// Open the build file of the directory whose build directory is given.
+  cmGeneratedFileStream* OpenDirectoryBuildFileStream(std::string const& dir);
+
+  /// Close the build file of a directory and include it from the main
+  /// build file by its path relative to the top of the build tree.
+  void CloseDirectoryBuildFileStream(cmGeneratedFileStream* os,
+                                     std::string const& path);
+
   void AddCXXCompileCommand(const std::string &commandLine,
                             const std::string &sourceFile);
 
@@ -348,6 +372,7 @@ private:
   /// edge of the compilation DAG).
   cmGeneratedFileStream* RulesFileStream;
   cmGeneratedFileStream* CompileCommandsStream;
+  bool UseDirectoryBuildFiles;
 
   /// The type used to store the set of rules added to the generated build
   /// system.
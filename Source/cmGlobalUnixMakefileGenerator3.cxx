@@ -307,6 +307,20 @@ void cmGlobalUnixMakefileGenerator3::WriteMainCMakefile()
     << "# The generator used is:\n"
     << "set(CMAKE_DEPENDS_GENERATOR \"" << this->GetName() << "\")\n\n";
 
+  // Tell the build system check to check dependencies of all targets
+  // if any directory's depend rules rely on it.
+  for (unsigned int i = 0; i < this->LocalGenerators.size(); ++i)
+    {
+    if (static_cast<cmLocalUnixMakefileGenerator3*>(this->LocalGenerators[i])
+        ->GetBatchDepends())
+      {
+      cmakefileStream
+        << "# Check dependencies of all targets with the build system:\n"
+        << "set(CMAKE_DEPENDS_BATCH ON)\n\n";
+      break;
+      }
+    }
+
   // for each cmMakefile get its list of dependencies
   std::vector<std::string> lfiles;
   for (unsigned int i = 0; i < this->LocalGenerators.size(); ++i)
@@ -784,14 +798,20 @@ cmGlobalUnixMakefileGenerator3
       progress.Dir += cmake::GetCMakeFilesDirectory();
       {
       std::ostringstream progressArg;
-      const char* sep = "";
-      std::vector<unsigned long>& progFiles =
-        this->ProgressMap[gtarget->Target].Marks;
-      for (std::vector<unsigned long>::iterator i = progFiles.begin();
-           i != progFiles.end(); ++i)
+      TargetProgress const& tp = this->ProgressMap[gtarget->Target];
+      if (lg->GetNativeEcho())
+        {
+        progressArg << tp.Percent;
+        }
+      else
         {
-        progressArg << sep << *i;
-        sep = ",";
+        const char* sep = "";
+        for (std::vector<unsigned long>::const_iterator i = tp.Marks.begin();
+             i != tp.Marks.end(); ++i)
+          {
+          progressArg << sep << *i;
+          sep = ",";
+          }
         }
       progress.Arg = progressArg.str();
       }
@@ -945,9 +965,22 @@ void
 cmGlobalUnixMakefileGenerator3::RecordTargetProgress(
   cmMakefileTargetGenerator* tg)
 {
-  TargetProgress& tp = this->ProgressMap[tg->GetTarget()];
-  tp.NumberOfActions = tg->GetNumberOfProgressActions();
-  tp.VariableFile = tg->GetProgressFileNameFull();
+  this->RecordTargetProgress(tg->GetTarget(),
+                             tg->GetNumberOfProgressActions(),
+                             tg->GetProgressFileNameFull());
+}
+
+//----------------------------------------------------------------------------
+void
+cmGlobalUnixMakefileGenerator3::RecordTargetProgress(
+  cmTarget const* target, unsigned long numberOfActions,
+  std::string const& variableFile)
+{
+  TargetProgress& tp = this->ProgressMap[target];
+  tp.NumberOfActions = numberOfActions;
+  tp.VariableFile = variableFile;
+  tp.NativeEcho = static_cast<cmLocalUnixMakefileGenerator3*>(
+    target->GetMakefile()->GetLocalGenerator())->GetNativeEcho();
 }
 
 //----------------------------------------------------------------------------
@@ -959,22 +992,36 @@ cmGlobalUnixMakefileGenerator3::TargetProgress
   for(unsigned long i = 1; i <= this->NumberOfActions; ++i)
     {
     fout << "CMAKE_PROGRESS_" << i << " = ";
+    unsigned long num = 0;
     if (total <= 100)
       {
-      unsigned long num = i + current;
-      fout << num;
-      this->Marks.push_back(num);
+      num = i + current;
       }
     else if (((i+current)*100)/total > ((i-1+current)*100)/total)
       {
-      unsigned long num = ((i+current)*100)/total;
-      fout << num;
+      num = ((i+current)*100)/total;
+      }
+    if (num)
+      {
       this->Marks.push_back(num);
       }
+    if (this->NativeEcho)
+      {
+      // The shell prints this percentage without any progress files.
+      fout << ((i+current)*100)/total;
+      }
+    else if (num)
+      {
+      fout << num;
+      }
     fout << "\n";
     }
   fout << "\n";
   current += this->NumberOfActions;
+  if (total > 0)
+    {
+    this->Percent = (current*100)/total;
+    }
 }
 
 //----------------------------------------------------------------------------
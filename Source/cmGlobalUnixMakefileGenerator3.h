@@ -120,6 +120,9 @@ public:
 
   /** Record per-target progress information.  */
   void RecordTargetProgress(cmMakefileTargetGenerator* tg);
+  void RecordTargetProgress(cmTarget const* target,
+                            unsigned long numberOfActions,
+                            std::string const& variableFile);
 
   void AddCXXCompileCommand(const std::string &sourceFile,
                             const std::string &workingDirectory,
@@ -179,8 +182,10 @@ protected:
   // Store per-target progress counters.
   struct TargetProgress
   {
-    TargetProgress(): NumberOfActions(0) {}
+    TargetProgress(): NumberOfActions(0), NativeEcho(false), Percent(0) {}
     unsigned long NumberOfActions;
+    bool NativeEcho;
+    unsigned long Percent;
     std::string VariableFile;
     std::vector<unsigned long> Marks;
     void WriteProgressVariables(unsigned long total, unsigned long& current);
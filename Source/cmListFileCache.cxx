@@ -13,11 +13,13 @@
 
 #include "cmListFileLexer.h"
 #include "cmLocalGenerator.h"
+#include "cmGeneratedFileStream.h"
 #include "cmSystemTools.h"
 #include "cmMakefile.h"
 #include "cmVersion.h"
 
 #include <cmsys/RegularExpression.hxx>
+#include <cmsys/FStream.hxx>
 
 
 //----------------------------------------------------------------------------
@@ -25,7 +27,7 @@ struct cmListFileParser
 {
   cmListFileParser(cmListFile* lf, cmMakefile* mf, const char* filename);
   ~cmListFileParser();
-  bool ParseFile();
+  bool ParseFile(std::string const& content);
   bool ParseFunction(const char* name, long line);
   bool AddArgument(cmListFileLexer_Token* token,
                    cmListFileArgument::Delimiter delim);
@@ -35,13 +37,14 @@ struct cmListFileParser
   cmListFileLexer* Lexer;
   cmListFileFunction Function;
   enum { SeparationOkay, SeparationWarning, SeparationError} Separation;
+  bool IssuedWarning;
 };
 
 //----------------------------------------------------------------------------
 cmListFileParser::cmListFileParser(cmListFile* lf, cmMakefile* mf,
                                    const char* filename):
   ListFile(lf), Makefile(mf), FileName(filename),
-  Lexer(cmListFileLexer_New())
+  Lexer(cmListFileLexer_New()), IssuedWarning(false)
 {
 }
 
@@ -52,22 +55,48 @@ cmListFileParser::~cmListFileParser()
 }
 
 //----------------------------------------------------------------------------
-bool cmListFileParser::ParseFile()
+static cmListFileLexer_BOM cmListFileParserReadBOM(std::string const& text,
+                                                   std::string::size_type& n)
 {
-  // Open the file.
-  cmListFileLexer_BOM bom;
-  if(!cmListFileLexer_SetFileName(this->Lexer, this->FileName, &bom))
+  unsigned char b[4] = {1, 1, 1, 1};
+  for(std::string::size_type i = 0; i < 4 && i < text.size(); ++i)
     {
-    cmSystemTools::Error("cmListFileCache: error can not open file ",
-                         this->FileName);
-    return false;
+    b[i] = static_cast<unsigned char>(text[i]);
+    }
+  n = 0;
+  if(b[0] == 0xEF && b[1] == 0xBB && b[2] == 0xBF)
+    {
+    n = 3;
+    return cmListFileLexer_BOM_UTF8;
+    }
+  else if(b[0] == 0xFE && b[1] == 0xFF)
+    {
+    return cmListFileLexer_BOM_UTF16BE;
+    }
+  else if(b[0] == 0 && b[1] == 0 && b[2] == 0xFE && b[3] == 0xFF)
+    {
+    return cmListFileLexer_BOM_UTF32BE;
+    }
+  else if(b[0] == 0xFF && b[1] == 0xFE)
+    {
+    if(b[2] == 0 && b[3] == 0)
+      {
+      return cmListFileLexer_BOM_UTF32LE;
+      }
+    return cmListFileLexer_BOM_UTF16LE;
     }
+  return cmListFileLexer_BOM_None;
+}
 
+//----------------------------------------------------------------------------
+bool cmListFileParser::ParseFile(std::string const& content)
+{
   // Verify the Byte-Order-Mark, if any.
+  std::string::size_type start;
+  cmListFileLexer_BOM bom = cmListFileParserReadBOM(content, start);
   if(bom != cmListFileLexer_BOM_None &&
      bom != cmListFileLexer_BOM_UTF8)
     {
-    cmListFileLexer_SetFileName(this->Lexer, 0, 0);
     std::ostringstream m;
     m << "File\n  " << this->FileName << "\n"
       << "starts with a Byte-Order-Mark that is not UTF-8.";
@@ -75,6 +104,30 @@ bool cmListFileParser::ParseFile()
     return false;
     }
 
+  // Lex the content already read by the caller instead of opening the
+  // file again.  Convert CRLF -> LF as the lexer does for file input.
+  std::string text;
+  text.reserve(content.size() - start);
+  for(std::string::size_type i = start; i < content.size(); ++i)
+    {
+    if(content[i] == '\r' && i+1 < content.size() && content[i+1] == '\n')
+      {
+      continue;
+      }
+    text += content[i];
+    }
+  // The string input stops at a null byte, so let the lexer read such
+  // a file itself and diagnose the byte.
+  int opened = (text.find('\0') == text.npos)?
+    cmListFileLexer_SetString(this->Lexer, text.c_str()) :
+    cmListFileLexer_SetFileName(this->Lexer, this->FileName, &bom);
+  if(!opened)
+    {
+    cmSystemTools::Error("cmListFileCache: error can not open file ",
+                         this->FileName);
+    return false;
+    }
+
   // Use a simple recursive-descent parser to process the token
   // stream.
   bool haveNewline = true;
@@ -134,6 +187,230 @@ bool cmListFileParser::ParseFile()
   return true;
 }
 
+//----------------------------------------------------------------------------
+// Files such as modules and project helper scripts are included many
+// times during one configure.  Keep the parsed functions of every list
+// file for the life of the process and reuse them while the content of
+// the file on disk is unchanged.  The size and a hash of the content are
+// compared because the modification time resolution is too coarse to
+// notice a file that is rewritten (e.g. by file(WRITE)) and included
+// again right away.
+struct cmListFileParsed
+{
+  std::string::size_type Size;
+  std::string Hash;
+  std::vector<cmListFileFunction> Functions;
+};
+typedef std::map<std::string, cmListFileParsed> cmListFileParsedMap;
+
+//----------------------------------------------------------------------------
+static cmListFileParsedMap& cmListFileGetParsedMap()
+{
+  static cmListFileParsedMap parsed;
+  return parsed;
+}
+
+//----------------------------------------------------------------------------
+static bool cmListFileReadContent(const char* filename, std::string& content)
+{
+  cmsys::ifstream fin(filename, std::ios::in | std::ios::binary);
+  if(!fin)
+    {
+    return false;
+    }
+  std::ostringstream str;
+  str << fin.rdbuf();
+  content = str.str();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+static void cmListFileSetArgumentPaths(
+  std::vector<cmListFileFunction>& functions, const char* path)
+{
+  for(std::vector<cmListFileFunction>::iterator fi = functions.begin();
+      fi != functions.end(); ++fi)
+    {
+    for(std::vector<cmListFileArgument>::iterator ai =
+          fi->Arguments.begin(); ai != fi->Arguments.end(); ++ai)
+      {
+      ai->FilePath = path;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// When CMAKE_LIST_FILE_CACHE is enabled the parsed functions are also
+// stored in the build tree so that later runs of CMake need not lex the
+// file again.  A stored file is used only when the size, modification
+// time and content hash recorded in it still match the list file.
+static const cmIML_INT_uint32_t cmListFileCacheMagic = 0x434d4c46;
+static const cmIML_INT_uint32_t cmListFileCacheFormat = 1;
+
+//----------------------------------------------------------------------------
+static std::string cmListFileCacheFileName(cmMakefile* mf,
+                                           const char* filename)
+{
+  std::string path = mf->GetHomeOutputDirectory();
+  path += cmake::GetCMakeFilesDirectory();
+  path += "/ListFileCache/";
+  path += cmSystemTools::ComputeStringMD5(filename);
+  path += ".bin";
+  return path;
+}
+
+//----------------------------------------------------------------------------
+static void cmListFileCacheWrite(std::ostream& os, cmIML_INT_uint64_t v)
+{
+  os.write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+//----------------------------------------------------------------------------
+static void cmListFileCacheWrite(std::ostream& os, std::string const& v)
+{
+  cmListFileCacheWrite(os, static_cast<cmIML_INT_uint64_t>(v.size()));
+  os.write(v.data(), static_cast<std::streamsize>(v.size()));
+}
+
+//----------------------------------------------------------------------------
+static bool cmListFileCacheRead(std::istream& is, cmIML_INT_uint64_t& v)
+{
+  return is.read(reinterpret_cast<char*>(&v), sizeof(v)) ? true : false;
+}
+
+//----------------------------------------------------------------------------
+static bool cmListFileCacheRead(std::istream& is, std::string& v)
+{
+  cmIML_INT_uint64_t n;
+  if(!cmListFileCacheRead(is, n) || n > 0x7fffffff)
+    {
+    return false;
+    }
+  v.resize(static_cast<std::string::size_type>(n));
+  return (n == 0 ||
+          is.read(&v[0], static_cast<std::streamsize>(n))) ? true : false;
+}
+
+//----------------------------------------------------------------------------
+static bool cmListFileCacheLoad(std::string const& cacheFile,
+                                const char* filename, long int mtime,
+                                std::string::size_type contentSize,
+                                std::string const& contentHash,
+                                std::vector<cmListFileFunction>& functions)
+{
+  cmsys::ifstream fin(cacheFile.c_str(), std::ios::in | std::ios::binary);
+  if(!fin)
+    {
+    return false;
+    }
+
+  // Check the header and whether the list file is unchanged.
+  cmIML_INT_uint64_t magic;
+  cmIML_INT_uint64_t format;
+  std::string version;
+  std::string path;
+  cmIML_INT_uint64_t size;
+  cmIML_INT_uint64_t time;
+  std::string hash;
+  if(!cmListFileCacheRead(fin, magic) || magic != cmListFileCacheMagic ||
+     !cmListFileCacheRead(fin, format) || format != cmListFileCacheFormat ||
+     !cmListFileCacheRead(fin, version) ||
+     version != cmVersion::GetCMakeVersion() ||
+     !cmListFileCacheRead(fin, path) || path != filename ||
+     !cmListFileCacheRead(fin, size) || size != contentSize ||
+     !cmListFileCacheRead(fin, time) ||
+     time != static_cast<cmIML_INT_uint64_t>(mtime) ||
+     !cmListFileCacheRead(fin, hash) ||
+     hash != contentHash)
+    {
+    return false;
+    }
+
+  // Read the functions.
+  std::vector<cmListFileFunction> loaded;
+  cmIML_INT_uint64_t numFunctions;
+  if(!cmListFileCacheRead(fin, numFunctions))
+    {
+    return false;
+    }
+  for(cmIML_INT_uint64_t i = 0; i < numFunctions; ++i)
+    {
+    cmListFileFunction lff;
+    cmIML_INT_uint64_t line;
+    cmIML_INT_uint64_t numArguments;
+    if(!cmListFileCacheRead(fin, lff.Name) ||
+       !cmListFileCacheRead(fin, line) ||
+       !cmListFileCacheRead(fin, numArguments))
+      {
+      return false;
+      }
+    lff.FilePath = filename;
+    lff.Line = static_cast<long>(line);
+    for(cmIML_INT_uint64_t j = 0; j < numArguments; ++j)
+      {
+      std::string value;
+      cmIML_INT_uint64_t delim;
+      cmIML_INT_uint64_t argLine;
+      if(!cmListFileCacheRead(fin, value) ||
+         !cmListFileCacheRead(fin, delim) ||
+         delim > static_cast<cmIML_INT_uint64_t>(
+                   cmListFileArgument::Bracket) ||
+         !cmListFileCacheRead(fin, argLine))
+        {
+        return false;
+        }
+      lff.Arguments.push_back(
+        cmListFileArgument(value,
+                           static_cast<cmListFileArgument::Delimiter>(delim),
+                           filename, static_cast<long>(argLine)));
+      }
+    loaded.push_back(lff);
+    }
+  functions.swap(loaded);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+static void cmListFileCacheSave(std::string const& cacheFile,
+                                const char* filename, long int mtime,
+                                std::string::size_type contentSize,
+                                std::string const& contentHash,
+                                std::vector<cmListFileFunction> const& fns)
+{
+  cmSystemTools::MakeDirectory(
+    cmSystemTools::GetFilenamePath(cacheFile).c_str());
+  cmGeneratedFileStream fout;
+  fout.Open(cacheFile.c_str(), true, true);
+  if(!fout)
+    {
+    return;
+    }
+  cmListFileCacheWrite(fout, cmListFileCacheMagic);
+  cmListFileCacheWrite(fout, cmListFileCacheFormat);
+  cmListFileCacheWrite(fout, std::string(cmVersion::GetCMakeVersion()));
+  cmListFileCacheWrite(fout, std::string(filename));
+  cmListFileCacheWrite(fout, static_cast<cmIML_INT_uint64_t>(contentSize));
+  cmListFileCacheWrite(fout, static_cast<cmIML_INT_uint64_t>(mtime));
+  cmListFileCacheWrite(fout, contentHash);
+  cmListFileCacheWrite(fout, static_cast<cmIML_INT_uint64_t>(fns.size()));
+  for(std::vector<cmListFileFunction>::const_iterator fi = fns.begin();
+      fi != fns.end(); ++fi)
+    {
+    cmListFileCacheWrite(fout, fi->Name);
+    cmListFileCacheWrite(fout, static_cast<cmIML_INT_uint64_t>(fi->Line));
+    cmListFileCacheWrite(fout,
+      static_cast<cmIML_INT_uint64_t>(fi->Arguments.size()));
+    for(std::vector<cmListFileArgument>::const_iterator ai =
+          fi->Arguments.begin(); ai != fi->Arguments.end(); ++ai)
+      {
+      cmListFileCacheWrite(fout, ai->Value);
+      cmListFileCacheWrite(fout, static_cast<cmIML_INT_uint64_t>(ai->Delim));
+      cmListFileCacheWrite(fout, static_cast<cmIML_INT_uint64_t>(ai->Line));
+      }
+    }
+  fout.Close();
+}
+
 //----------------------------------------------------------------------------
 bool cmListFile::ParseFile(const char* filename,
                            bool topLevel,
@@ -148,10 +425,69 @@ bool cmListFile::ParseFile(const char* filename,
   bool parseError = false;
   this->ModifiedTime = cmSystemTools::ModifiedTime(filename);
 
-  {
-  cmListFileParser parser(this, mf, filename);
-  parseError = !parser.ParseFile();
-  }
+  std::string content;
+  bool haveContent = cmListFileReadContent(filename, content);
+  std::string hash = cmSystemTools::ComputeStringMD5(content);
+  cmListFileParsedMap& parsedMap = cmListFileGetParsedMap();
+  cmListFileParsedMap::iterator pi = parsedMap.find(filename);
+  if(haveContent && pi != parsedMap.end() &&
+     pi->second.Size == content.size() && pi->second.Hash == hash)
+    {
+    this->Functions = pi->second.Functions;
+    }
+  else
+    {
+    bool persistent = haveContent && mf->IsOn("CMAKE_LIST_FILE_CACHE");
+    std::string cacheFile;
+    bool loaded = false;
+    bool issuedWarning = false;
+    if(persistent)
+      {
+      cacheFile = cmListFileCacheFileName(mf, filename);
+      loaded = cmListFileCacheLoad(cacheFile, filename, this->ModifiedTime,
+                                   content.size(), hash, this->Functions);
+      if(loaded && mf->GetCMakeInstance()->GetDebugOutput())
+        {
+        std::string msg = "Reusing parse of ";
+        msg += filename;
+        cmSystemTools::Message(msg.c_str());
+        }
+      }
+    if(!haveContent)
+      {
+      cmSystemTools::Error("cmListFileCache: error can not open file ",
+                           filename);
+      parseError = true;
+      }
+    else if(!loaded)
+      {
+      cmListFileParser parser(this, mf, filename);
+      parseError = !parser.ParseFile(content);
+      issuedWarning = parser.IssuedWarning;
+      }
+
+    // Only remember files that parsed cleanly so that diagnostics are
+    // reported every time the file is read.
+    if(haveContent && !parseError && !issuedWarning)
+      {
+      if(persistent && !loaded)
+        {
+        cmListFileCacheSave(cacheFile, filename, this->ModifiedTime,
+                            content.size(), hash, this->Functions);
+        }
+      if(pi == parsedMap.end())
+        {
+        pi = parsedMap.insert(
+          cmListFileParsedMap::value_type(filename, cmListFileParsed())).first;
+        }
+      // The cached arguments refer to the file name owned by the map key
+      // so that they outlive the caller's buffer.
+      pi->second.Size = content.size();
+      pi->second.Hash = hash;
+      pi->second.Functions = this->Functions;
+      cmListFileSetArgumentPaths(pi->second.Functions, pi->first.c_str());
+      }
+    }
 
   if(parseError)
     {
@@ -402,26 +738,146 @@ bool cmListFileParser::AddArgument(cmListFileLexer_Token* token,
   else
     {
     this->Makefile->IssueMessage(cmake::AUTHOR_WARNING, m.str());
+    this->IssuedWarning = true;
     return true;
     }
 }
 
 //----------------------------------------------------------------------------
-void cmListFileBacktrace::MakeRelative()
+struct cmListFileBacktrace::Entry
+{
+  Entry(cmListFileContext const& lfc, Entry* up);
+  std::string Name;
+  std::string const* FilePath;
+  long Line;
+  Entry* Up;
+  unsigned int RefCount;
+};
+
+//----------------------------------------------------------------------------
+static std::string const* cmListFileBacktraceInternPath(std::string const& p)
+{
+  static std::set<std::string> paths;
+  return &*paths.insert(p).first;
+}
+
+//----------------------------------------------------------------------------
+cmListFileBacktrace::Entry::Entry(cmListFileContext const& lfc, Entry* up):
+  Name(lfc.Name), FilePath(cmListFileBacktraceInternPath(lfc.FilePath)),
+  Line(lfc.Line), Up(up), RefCount(1)
 {
-  if (this->Relative)
+  if(this->Up)
     {
-    return;
+    ++this->Up->RefCount;
+    }
+}
+
+//----------------------------------------------------------------------------
+cmListFileBacktrace::cmListFileBacktrace(cmLocalGenerator* localGen):
+  LocalGenerator(localGen), Cur(0)
+{
+}
+
+//----------------------------------------------------------------------------
+cmListFileBacktrace::cmListFileBacktrace(cmLocalGenerator* localGen,
+                                         Entry* cur):
+  LocalGenerator(localGen), Cur(cur)
+{
+}
+
+//----------------------------------------------------------------------------
+cmListFileBacktrace::cmListFileBacktrace(cmListFileBacktrace const& r):
+  LocalGenerator(r.LocalGenerator), Cur(r.Cur)
+{
+  if(this->Cur)
+    {
+    ++this->Cur->RefCount;
     }
-  for (cmListFileBacktrace::iterator i = this->begin();
-       i != this->end(); ++i)
+}
+
+//----------------------------------------------------------------------------
+cmListFileBacktrace&
+cmListFileBacktrace::operator=(cmListFileBacktrace const& r)
+{
+  cmListFileBacktrace tmp(r);
+  std::swap(this->LocalGenerator, tmp.LocalGenerator);
+  std::swap(this->Cur, tmp.Cur);
+  return *this;
+}
+
+//----------------------------------------------------------------------------
+cmListFileBacktrace::~cmListFileBacktrace()
+{
+  Entry* e = this->Cur;
+  while(e && --e->RefCount == 0)
     {
-    i->FilePath = this->LocalGenerator->Convert(i->FilePath,
-                                                cmLocalGenerator::HOME);
+    Entry* up = e->Up;
+    delete e;
+    e = up;
     }
-  this->Relative = true;
 }
 
+//----------------------------------------------------------------------------
+cmListFileBacktrace
+cmListFileBacktrace::Push(cmListFileContext const& lfc) const
+{
+  return cmListFileBacktrace(this->LocalGenerator,
+                             new Entry(lfc, this->Cur));
+}
+
+//----------------------------------------------------------------------------
+cmListFileContext cmListFileBacktrace::Top() const
+{
+  cmListFileContext lfc;
+  lfc.Name = this->Cur->Name;
+  lfc.FilePath = *this->Cur->FilePath;
+  lfc.Line = this->Cur->Line;
+  return lfc;
+}
+
+//----------------------------------------------------------------------------
+void cmListFileBacktrace::PrintEntry(std::ostream& out, Entry const* e) const
+{
+  cmListFileContext lfc;
+  lfc.Name = e->Name;
+  lfc.Line = e->Line;
+  if(this->LocalGenerator)
+    {
+    lfc.FilePath = this->LocalGenerator->Convert(*e->FilePath,
+                                                 cmLocalGenerator::HOME);
+    }
+  else
+    {
+    lfc.FilePath = *e->FilePath;
+    }
+  out << lfc;
+}
+
+//----------------------------------------------------------------------------
+void cmListFileBacktrace::PrintTitle(std::ostream& out) const
+{
+  if(this->Cur)
+    {
+    out << (this->Cur->Line? " at ": " in ");
+    this->PrintEntry(out, this->Cur);
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmListFileBacktrace::PrintCallStack(std::ostream& out) const
+{
+  if(!this->Cur || !this->Cur->Up)
+    {
+    return;
+    }
+  out << "Call Stack (most recent call first):\n";
+  for(Entry const* e = this->Cur->Up; e; e = e->Up)
+    {
+    out << "  ";
+    this->PrintEntry(out, e);
+    out << "\n";
+    }
+}
 
 //----------------------------------------------------------------------------
 std::ostream& operator<<(std::ostream& os, cmListFileContext const& lfc)
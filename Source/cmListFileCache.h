@@ -25,6 +25,38 @@ class cmLocalGenerator;
 
 class cmMakefile;
 
+/** \class cmListFileArgumentTokens
+ * \brief The variable references of a list file argument, parsed once.
+ *
+ * cmMakefile splits an argument that is expanded repeatedly into literal
+ * text and the opening and closing of variable references so that later
+ * expansions do not parse the text again.  It is allocated when needed
+ * and shared by all copies of the argument made after that.
+ */
+struct cmListFileArgumentTokens
+{
+  enum TokenType
+    {
+    Literal,
+    Open,
+    Close
+    };
+  struct Token
+  {
+    TokenType Type;
+    int Domain;   // The kind of reference opened.
+    long Line;    // The line offset of a reference closed.
+    std::string Text;
+  };
+  cmListFileArgumentTokens():
+    RefCount(1), Uses(0), Compiled(false), Valid(false) {}
+  unsigned int RefCount;
+  unsigned int Uses;
+  bool Compiled;
+  bool Valid;
+  std::vector<Token> Tokens;
+};
+
 struct cmListFileArgument
 {
   enum Delimiter
@@ -33,12 +65,37 @@ struct cmListFileArgument
     Quoted,
     Bracket
     };
-  cmListFileArgument(): Value(), Delim(Unquoted), FilePath(0), Line(0) {}
+  cmListFileArgument(): Value(), Delim(Unquoted), FilePath(0), Line(0),
+                        Expanded(false), Tokens(0) {}
   cmListFileArgument(const cmListFileArgument& r):
-    Value(r.Value), Delim(r.Delim), FilePath(r.FilePath), Line(r.Line) {}
+    Value(r.Value), Delim(r.Delim), FilePath(r.FilePath), Line(r.Line),
+    Expanded(r.Expanded), Tokens(r.Tokens)
+    {
+    if(this->Tokens)
+      {
+      ++this->Tokens->RefCount;
+      }
+    }
   cmListFileArgument(const std::string& v, Delimiter d, const char* file,
                      long line): Value(v), Delim(d),
-                                 FilePath(file), Line(line) {}
+                                 FilePath(file), Line(line),
+                                 Expanded(false), Tokens(0) {}
+  ~cmListFileArgument() { this->ReleaseTokens(); }
+  cmListFileArgument& operator=(const cmListFileArgument& r)
+    {
+    if(r.Tokens)
+      {
+      ++r.Tokens->RefCount;
+      }
+    this->ReleaseTokens();
+    this->Value = r.Value;
+    this->Delim = r.Delim;
+    this->FilePath = r.FilePath;
+    this->Line = r.Line;
+    this->Expanded = r.Expanded;
+    this->Tokens = r.Tokens;
+    return *this;
+    }
   bool operator == (const cmListFileArgument& r) const
     {
     return (this->Value == r.Value) && (this->Delim == r.Delim);
@@ -51,6 +108,29 @@ struct cmListFileArgument
   Delimiter Delim;
   const char* FilePath;
   long Line;
+  // Whether cmMakefile has expanded this argument before.
+  mutable bool Expanded;
+  // The parsed form of Value, allocated once the argument is expanded a
+  // second time or shared before copying.  The value must not be
+  // modified after that.
+  mutable cmListFileArgumentTokens* Tokens;
+  /** Allocate the parsed form now so that copies made later share it
+      and count their expansions together.  */
+  void ShareTokens() const
+    {
+    if(!this->Tokens && this->Delim != Bracket)
+      {
+      this->Tokens = new cmListFileArgumentTokens;
+      }
+    }
+private:
+  void ReleaseTokens()
+    {
+    if(this->Tokens && --this->Tokens->RefCount == 0)
+      {
+      delete this->Tokens;
+      }
+    }
 };
 
 struct cmListFileContext
@@ -68,19 +148,43 @@ struct cmListFileFunction: public cmListFileContext
   std::vector<cmListFileArgument> Arguments;
 };
 
-class cmListFileBacktrace: public std::vector<cmListFileContext>
+/** \class cmListFileBacktrace
+ * \brief The call stack of a command, shared between backtraces.
+ *
+ * Each frame links to the frame of its caller and is shared, with its
+ * callers, by every backtrace taken below it.  Backtraces are immutable
+ * and cheap to copy.  The file paths of the frames are interned.
+ */
+class cmListFileBacktrace
 {
-  public:
-    cmListFileBacktrace(cmLocalGenerator* localGen)
-      : LocalGenerator(localGen)
-      , Relative(localGen ? false : true)
-    {
-    }
-
-    void MakeRelative();
-  private:
-    cmLocalGenerator* LocalGenerator;
-    bool Relative;
+public:
+  cmListFileBacktrace(cmLocalGenerator* localGen = 0);
+  cmListFileBacktrace(cmListFileBacktrace const& r);
+  cmListFileBacktrace& operator=(cmListFileBacktrace const& r);
+  ~cmListFileBacktrace();
+
+  /** Get a backtrace whose innermost frame is the given context, called
+      from the frames of this backtrace.  */
+  cmListFileBacktrace Push(cmListFileContext const& lfc) const;
+
+  /** Whether the backtrace has no frames.  */
+  bool Empty() const { return !this->Cur; }
+
+  /** Get the innermost frame.  The backtrace must not be empty.  */
+  cmListFileContext Top() const;
+
+  /** Print the innermost frame as the location of a message.  */
+  void PrintTitle(std::ostream& out) const;
+
+  /** Print the frames of the callers, if any, most recent first.  */
+  void PrintCallStack(std::ostream& out) const;
+private:
+  struct Entry;
+  void PrintEntry(std::ostream& out, Entry const* e) const;
+  cmListFileBacktrace(cmLocalGenerator* localGen, Entry* cur);
+
+  cmLocalGenerator* LocalGenerator;
+  Entry* Cur;
 };
 
 struct cmListFile
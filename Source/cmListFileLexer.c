@@ -2604,7 +2604,7 @@ int cmListFileLexer_SetString(cmListFileLexer* lexer, const char* text)
 /*--------------------------------------------------------------------------*/
 cmListFileLexer_Token* cmListFileLexer_Scan(cmListFileLexer* lexer)
 {
-  if(!lexer->file)
+  if(!lexer->file && !lexer->string_buffer)
     {
     return 0;
     }
@@ -2622,7 +2622,7 @@ cmListFileLexer_Token* cmListFileLexer_Scan(cmListFileLexer* lexer)
 /*--------------------------------------------------------------------------*/
 long cmListFileLexer_GetCurrentLine(cmListFileLexer* lexer)
 {
-  if(lexer->file)
+  if(lexer->file || lexer->string_buffer)
     {
     return lexer->line;
     }
@@ -2635,7 +2635,7 @@ long cmListFileLexer_GetCurrentLine(cmListFileLexer* lexer)
 /*--------------------------------------------------------------------------*/
 long cmListFileLexer_GetCurrentColumn(cmListFileLexer* lexer)
 {
-  if(lexer->file)
+  if(lexer->file || lexer->string_buffer)
     {
     return lexer->column;
     }
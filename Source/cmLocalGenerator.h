@@ -223,6 +223,11 @@ public:
   virtual void ClearDependencies(cmMakefile* /* mf */,
                                  bool /* verbose */) {}
 
+  /** Called from command-line hook to check dependencies of all
+      targets at once.  */
+  virtual void CheckDependencies(cmMakefile* /* mf */,
+                                 bool /* verbose */) {}
+
   /** Called from command-line hook to update dependencies.  */
   virtual bool UpdateDependencies(const char* /* tgtInfo */,
                                   bool /*verbose*/,
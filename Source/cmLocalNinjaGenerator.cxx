@@ -25,6 +25,7 @@ cmLocalNinjaGenerator::cmLocalNinjaGenerator()
   : cmLocalGenerator()
   , ConfigName("")
   , HomeRelativeOutputPath("")
+  , DirectoryBuildFileStream(0)
 {
 #ifdef _WIN32
   this->WindowsShell = true;
@@ -43,6 +44,13 @@ void cmLocalNinjaGenerator::Generate()
 {
   this->SetConfigName();
 
+  cmGlobalNinjaGenerator* gg = this->GetGlobalNinjaGenerator();
+  if(gg->GetUseDirectoryBuildFiles())
+    {
+    this->DirectoryBuildFileStream = gg->OpenDirectoryBuildFileStream(
+      this->Makefile->GetStartOutputDirectory());
+    }
+
   this->WriteProcessedMakefile(this->GetBuildFileStream());
 #ifdef NINJA_GEN_VERBOSE_FILES
   this->WriteProcessedMakefile(this->GetRulesFileStream());
@@ -79,6 +87,7 @@ void cmLocalNinjaGenerator::Generate()
     if(tg)
       {
       tg->Generate();
+      tg->WriteBuildStatements(this->GetBuildFileStream());
       // Add the target to "all" if required.
       if (!this->GetGlobalNinjaGenerator()->IsExcluded(
             this->GetGlobalNinjaGenerator()->GetLocalGenerators()[0],
@@ -89,6 +98,16 @@ void cmLocalNinjaGenerator::Generate()
     }
 
   this->WriteCustomCommandBuildStatements();
+
+  if(this->DirectoryBuildFileStream)
+    {
+    std::string path = this->Makefile->GetStartOutputDirectory();
+    path += "/";
+    path += cmGlobalNinjaGenerator::NINJA_DIRECTORY_BUILD_FILE;
+    gg->CloseDirectoryBuildFileStream(this->DirectoryBuildFileStream,
+                                      this->ConvertToNinjaPath(path));
+    this->DirectoryBuildFileStream = 0;
+    }
 }
 
 // Implemented in:
@@ -160,8 +179,12 @@ cmLocalNinjaGenerator::ConvertToIncludeReference(std::string const& path,
 //----------------------------------------------------------------------------
 // Private methods.
 
-cmGeneratedFileStream& cmLocalNinjaGenerator::GetBuildFileStream() const
+std::ostream& cmLocalNinjaGenerator::GetBuildFileStream() const
 {
+  if(this->DirectoryBuildFileStream)
+    {
+    return *this->DirectoryBuildFileStream;
+    }
   return *this->GetGlobalNinjaGenerator()->GetBuildFileStream();
 }
 
@@ -187,10 +210,13 @@ bool cmLocalNinjaGenerator::isRootMakefile() const
 
 void cmLocalNinjaGenerator::WriteBuildFileTop()
 {
-  // For the build file.
-  this->WriteProjectHeader(this->GetBuildFileStream());
-  this->WriteNinjaRequiredVersion(this->GetBuildFileStream());
-  this->WriteNinjaFilesInclusion(this->GetBuildFileStream());
+  // For the build file.  It is always the main one even if the top
+  // directory has its own.
+  cmGeneratedFileStream& os =
+    *this->GetGlobalNinjaGenerator()->GetBuildFileStream();
+  this->WriteProjectHeader(os);
+  this->WriteNinjaRequiredVersion(os);
+  this->WriteNinjaFilesInclusion(os);
 
   // For the rule file.
   this->WriteProjectHeader(this->GetRulesFileStream());
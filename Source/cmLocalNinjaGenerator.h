@@ -113,7 +113,7 @@ protected:
 
 
 private:
-  cmGeneratedFileStream& GetBuildFileStream() const;
+  std::ostream& GetBuildFileStream() const;
   cmGeneratedFileStream& GetRulesFileStream() const;
 
   void WriteBuildFileTop();
@@ -136,6 +136,9 @@ private:
   std::string ConfigName;
   std::string HomeRelativeOutputPath;
 
+  // The build file of this directory, if it has its own.
+  cmGeneratedFileStream* DirectoryBuildFileStream;
+
   typedef std::map<cmCustomCommand const*, std::set<cmTarget*> >
     CustomCommandTargetMap;
   CustomCommandTargetMap CustomCommandTargets;
@@ -20,6 +20,7 @@
 #include "cmVersion.h"
 #include "cmFileTimeComparison.h"
 #include "cmCustomCommandGenerator.h"
+#include "cmComputeLinkInformation.h"
 
 // Include dependency scanners for supported languages.  Only the
 // C/C++ scanner is needed for bootstrapping CMake.
@@ -88,8 +89,12 @@ cmLocalUnixMakefileGenerator3::cmLocalUnixMakefileGenerator3()
   this->DefineWindowsNULL = false;
   this->UnixCD = true;
   this->ColorMakefile = false;
+  this->NativeEcho = false;
+  this->BatchDepends = false;
+  this->CompilerDepends = false;
   this->SkipPreprocessedSourceRules = false;
   this->SkipAssemblySourceRules = false;
+  this->SkipUnchanged = false;
   this->MakeCommandEscapeTargetTwice = false;
   this->BorlandMakeCurlyHack = false;
 }
@@ -138,12 +143,40 @@ void cmLocalUnixMakefileGenerator3::Generate()
     {
     this->ColorMakefile = this->Makefile->IsOn("CMAKE_COLOR_MAKEFILE");
     }
+  this->NativeEcho = !this->WindowsShell &&
+    this->Makefile->IsOn("CMAKE_MAKEFILE_NATIVE_ECHO");
+  this->BatchDepends = !this->WindowsShell &&
+    this->Makefile->IsOn("CMAKE_MAKEFILE_BATCH_DEPENDS");
+  this->CompilerDepends =
+    this->Makefile->IsOn("CMAKE_MAKEFILE_COMPILER_DEPENDS");
   this->SkipPreprocessedSourceRules =
     this->Makefile->IsOn("CMAKE_SKIP_PREPROCESSED_SOURCE_RULES");
   this->SkipAssemblySourceRules =
     this->Makefile->IsOn("CMAKE_SKIP_ASSEMBLY_SOURCE_RULES");
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // The top Makefile is always written because the build system check
+  // compares its time stamp to those of the inputs.  Compile commands
+  // are collected from all directories while they are written.
+  this->SkipUnchanged = this->Parent &&
+    this->Makefile->IsOn("CMAKE_MAKEFILE_SKIP_UNCHANGED_DIRECTORIES") &&
+    !this->Makefile->IsOn("CMAKE_EXPORT_COMPILE_COMMANDS");
+#endif
+
+  // Keep the files of this directory if they were written from the same
+  // inputs.  Otherwise drop the old fingerprint before writing them.
+  std::string fingerprint;
+  if(this->SkipUnchanged)
+    {
+    fingerprint = this->ComputeFingerprint();
+    if(this->ReuseFingerprintFile(fingerprint))
+      {
+      return;
+      }
+    }
+  cmSystemTools::RemoveFile(this->GetFingerprintFileName());
 
   // Generate the rule files for each target.
+  TargetProgressVector progress;
   cmGeneratorTargetsType targets = this->Makefile->GetGeneratorTargets();
   cmGlobalUnixMakefileGenerator3* gg =
     static_cast<cmGlobalUnixMakefileGenerator3*>(this->GlobalGenerator);
@@ -161,6 +194,8 @@ void cmLocalUnixMakefileGenerator3::Generate()
       {
       tg->WriteRuleFiles();
       gg->RecordTargetProgress(tg.get());
+      progress.push_back(std::make_pair(t->second->GetName(),
+                                        tg->GetNumberOfProgressActions()));
       }
     }
 
@@ -169,6 +204,299 @@ void cmLocalUnixMakefileGenerator3::Generate()
 
   // Write the cmake file with information for this directory.
   this->WriteDirectoryInformationFile();
+
+  if(this->SkipUnchanged && !cmSystemTools::GetErrorOccuredFlag())
+    {
+    this->WriteFingerprintFile(fingerprint, progress);
+    }
+}
+
+//----------------------------------------------------------------------------
+std::string cmLocalUnixMakefileGenerator3::GetFingerprintFileName()
+{
+  std::string fname = this->Makefile->GetStartOutputDirectory();
+  fname += cmake::GetCMakeFilesDirectory();
+  fname += "/Fingerprint.txt";
+  return fname;
+}
+
+//----------------------------------------------------------------------------
+static void
+cmLocalUnixMakefileGeneratorAppendProperties(std::ostream& os,
+                                             const char* kind,
+                                             cmPropertyMap const& props)
+{
+  // Sort the entries so that the order in which the properties were
+  // set does not matter.
+  std::vector<std::string> entries;
+  for(cmPropertyMap::const_iterator pi = props.begin();
+      pi != props.end(); ++pi)
+    {
+    const char* value = pi->second.GetValue();
+    entries.push_back(pi->first + "=" + (value? value : ""));
+    }
+  std::sort(entries.begin(), entries.end());
+  for(std::vector<std::string>::const_iterator ei = entries.begin();
+      ei != entries.end(); ++ei)
+    {
+    os << kind << " " << *ei << "\n";
+    }
+}
+
+//----------------------------------------------------------------------------
+std::string cmLocalUnixMakefileGenerator3::ComputeFingerprint()
+{
+  std::ostringstream fp;
+  fp << "version " << cmVersion::GetCMakeVersion() << "\n"
+     << "generator " << this->GlobalGenerator->GetName() << "\n"
+     << "config " << this->ConfigurationName << "\n";
+
+  // Variables include the compiler rules and flags.
+  std::vector<std::string> defs = this->Makefile->GetDefinitions();
+  for(std::vector<std::string>::const_iterator di = defs.begin();
+      di != defs.end(); ++di)
+    {
+    fp << "variable " << *di << "="
+       << this->Makefile->GetSafeDefinition(*di) << "\n";
+    }
+  fp << "include regex " << this->Makefile->GetIncludeRegularExpression()
+     << "\n"
+     << "complain regex " << this->Makefile->GetComplainRegularExpression()
+     << "\n";
+  cmLocalUnixMakefileGeneratorAppendProperties(
+    fp, "directory property", this->Makefile->GetProperties());
+
+  // Visit the targets in a fixed order.
+  std::map<std::string, cmGeneratorTarget*> targets;
+  cmGeneratorTargetsType const& gts = this->Makefile->GetGeneratorTargets();
+  for(cmGeneratorTargetsType::const_iterator ti = gts.begin();
+      ti != gts.end(); ++ti)
+    {
+    if(!ti->second->Target->IsImported())
+      {
+      targets[ti->second->GetName()] = ti->second;
+      }
+    }
+  for(std::map<std::string, cmGeneratorTarget*>::const_iterator
+        ti = targets.begin(); ti != targets.end(); ++ti)
+    {
+    this->AppendTargetFingerprint(fp, ti->second);
+    }
+  return cmSystemTools::ComputeStringMD5(fp.str());
+}
+
+//----------------------------------------------------------------------------
+void
+cmLocalUnixMakefileGenerator3::AppendTargetFingerprint(std::ostream& fp,
+                                                       cmGeneratorTarget* gt)
+{
+  cmTarget* target = gt->Target;
+  std::string const& config = this->ConfigurationName;
+  fp << "target " << target->GetName() << " " << target->GetType() << "\n";
+  cmLocalUnixMakefileGeneratorAppendProperties(fp, "property",
+                                               target->GetProperties());
+  if(target->GetType() == cmTarget::INTERFACE_LIBRARY)
+    {
+    return;
+    }
+
+  // Sources, including their custom commands.
+  std::vector<cmSourceFile*> sources;
+  gt->GetSourceFiles(sources, config);
+  for(std::vector<cmSourceFile*>::const_iterator si = sources.begin();
+      si != sources.end(); ++si)
+    {
+    cmSourceFile* sf = *si;
+    fp << "source " << sf->GetFullPath() << " " << sf->GetLanguage() << "\n";
+    cmLocalUnixMakefileGeneratorAppendProperties(fp, "source property",
+                                                 sf->GetProperties());
+    if(cmCustomCommand const* cc = sf->GetCustomCommand())
+      {
+      this->AppendCustomCommandFingerprint(fp, *cc, target);
+      }
+    }
+  std::vector<cmCustomCommand> const* targetCommands[] =
+    {
+    &target->GetPreBuildCommands(),
+    &target->GetPreLinkCommands(),
+    &target->GetPostBuildCommands()
+    };
+  for(unsigned int i = 0; i < 3; ++i)
+    {
+    fp << "target commands " << i << "\n";
+    for(std::vector<cmCustomCommand>::const_iterator
+          ci = targetCommands[i]->begin(); ci != targetCommands[i]->end();
+        ++ci)
+      {
+      this->AppendCustomCommandFingerprint(fp, *ci, target);
+      }
+    }
+
+  // Usage requirements, which may come from targets in any directory.
+  std::set<std::string> languages;
+  target->GetLanguages(languages, config);
+  for(std::set<std::string>::const_iterator li = languages.begin();
+      li != languages.end(); ++li)
+    {
+    std::vector<std::string> values = target->GetIncludeDirectories(config,
+                                                                    *li);
+    values.push_back("defines");
+    target->GetCompileDefinitions(values, config, *li);
+    values.push_back("options");
+    target->GetCompileOptions(values, config, *li);
+    fp << "language " << *li << " " << cmJoin(values, ";") << "\n";
+    }
+  if(!languages.empty())
+    {
+    std::vector<std::string> features;
+    target->GetCompileFeatures(features, config);
+    fp << "features " << cmJoin(features, ";") << "\n";
+    }
+
+  // Every target with rule files asks for its link information.
+  switch(target->GetType())
+    {
+    case cmTarget::EXECUTABLE:
+    case cmTarget::STATIC_LIBRARY:
+    case cmTarget::SHARED_LIBRARY:
+    case cmTarget::MODULE_LIBRARY:
+    case cmTarget::OBJECT_LIBRARY:
+    case cmTarget::UTILITY:
+      break;
+    default:
+      return;
+    }
+  if(target->GetType() != cmTarget::OBJECT_LIBRARY &&
+     target->GetType() != cmTarget::UTILITY)
+    {
+    fp << "output " << target->GetFullPath(config) << "\n";
+    }
+  if(cmComputeLinkInformation* cli = target->GetLinkInformation(config))
+    {
+    fp << "link language " << cli->GetLinkLanguage() << "\n";
+    cmComputeLinkInformation::ItemVector const& items = cli->GetItems();
+    for(cmComputeLinkInformation::ItemVector::const_iterator
+          ii = items.begin(); ii != items.end(); ++ii)
+      {
+      fp << "link item " << ii->IsPath << " " << ii->Value;
+      if(cmTarget const* linkee = ii->Target)
+        {
+        fp << " " << linkee->GetMakefile()->GetStartOutputDirectory();
+        }
+      fp << "\n";
+      }
+    fp << "link directories " << cmJoin(cli->GetDirectories(), ";") << "\n"
+       << "link depends " << cmJoin(cli->GetDepends(), ";") << "\n"
+       << "link frameworks " << cmJoin(cli->GetFrameworkPaths(), ";")
+       << "\n"
+       << "rpath " << cli->GetRPathString(false) << "\n"
+       << "install rpath " << cli->GetRPathString(true) << "\n"
+       << "chrpath " << cli->GetChrpathString() << "\n";
+    }
+}
+
+//----------------------------------------------------------------------------
+void
+cmLocalUnixMakefileGenerator3
+::AppendCustomCommandFingerprint(std::ostream& fp, cmCustomCommand const& cc,
+                                 cmTarget* target)
+{
+  // Use the commands and dependencies as they are written to the rules.
+  cmCustomCommandGenerator ccg(cc, this->ConfigurationName, this->Makefile);
+  std::vector<std::string> commands;
+  this->AppendCustomCommand(commands, ccg, target, true);
+  std::vector<std::string> depends;
+  this->AppendCustomDepend(depends, ccg);
+  fp << "command " << cmJoin(commands, "\n") << "\n"
+     << "depends " << cmJoin(depends, ";") << "\n"
+     << "outputs " << cmJoin(ccg.GetOutputs(), ";") << "\n"
+     << "byproducts " << cmJoin(ccg.GetByproducts(), ";") << "\n";
+  cmCustomCommand::ImplicitDependsList const& implicit =
+    cc.GetImplicitDepends();
+  for(cmCustomCommand::ImplicitDependsList::const_iterator
+        ii = implicit.begin(); ii != implicit.end(); ++ii)
+    {
+    fp << "implicit " << ii->first << " " << ii->second << "\n";
+    }
+}
+
+//----------------------------------------------------------------------------
+bool
+cmLocalUnixMakefileGenerator3
+::ReuseFingerprintFile(std::string const& fingerprint)
+{
+  cmsys::ifstream fin(this->GetFingerprintFileName().c_str());
+  std::string line;
+  if(fingerprint.empty() || !fin ||
+     !cmSystemTools::GetLineFromStream(fin, line) || line != fingerprint)
+    {
+    return false;
+    }
+
+  // The file lists the number of progress actions of each target with
+  // rule files.  Make sure these files still exist.
+  std::string dir = this->Makefile->GetStartOutputDirectory();
+  dir += "/";
+  std::string makefile = dir + "Makefile";
+  if(!cmSystemTools::FileExists(makefile.c_str()))
+    {
+    return false;
+    }
+  TargetProgressVector progress;
+  while(cmSystemTools::GetLineFromStream(fin, line))
+    {
+    std::string::size_type pos = line.find(' ');
+    if(pos == line.npos)
+      {
+      return false;
+      }
+    std::string name = line.substr(pos + 1);
+    cmTarget const* target = this->Makefile->FindTarget(name);
+    if(!target)
+      {
+      return false;
+      }
+    std::string tdir = dir + this->GetTargetDirectory(*target);
+    std::string buildFile = tdir + "/build.make";
+    if(!cmSystemTools::FileExists(buildFile.c_str()))
+      {
+      return false;
+      }
+    progress.push_back(std::make_pair(name,
+      strtoul(line.substr(0, pos).c_str(), 0, 10)));
+    }
+
+  // Record the progress that writing the rule files would have recorded.
+  cmGlobalUnixMakefileGenerator3* gg =
+    static_cast<cmGlobalUnixMakefileGenerator3*>(this->GlobalGenerator);
+  for(TargetProgressVector::const_iterator pi = progress.begin();
+      pi != progress.end(); ++pi)
+    {
+    cmTarget const* target = this->Makefile->FindTarget(pi->first);
+    std::string progressFile = dir + this->GetTargetDirectory(*target);
+    progressFile += "/progress.make";
+    gg->RecordTargetProgress(target, pi->second, progressFile);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void
+cmLocalUnixMakefileGenerator3
+::WriteFingerprintFile(std::string const& fingerprint,
+                       TargetProgressVector const& progress)
+{
+  if(fingerprint.empty())
+    {
+    return;
+    }
+  cmGeneratedFileStream fout(this->GetFingerprintFileName().c_str());
+  fout << fingerprint << "\n";
+  for(TargetProgressVector::const_iterator pi = progress.begin();
+      pi != progress.end(); ++pi)
+    {
+    fout << pi->second << " " << pi->first << "\n";
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -1289,8 +1617,10 @@ cmLocalUnixMakefileGenerator3::AppendEcho(std::vector<std::string>& commands,
                                           EchoColor color,
                                           EchoProgress const* progress)
 {
-  // Choose the color for the text.
+  // Choose the color for the text.  The escape sequences are used when
+  // the shell prints the text natively.
   std::string color_name;
+  const char* color_code = "";
   if(this->GlobalGenerator->GetToolSupportsColor() && this->ColorMakefile)
     {
     // See cmake::ExecuteEchoColor in cmake.cxx for these options.
@@ -1301,18 +1631,23 @@ cmLocalUnixMakefileGenerator3::AppendEcho(std::vector<std::string>& commands,
         break;
       case EchoDepend:
         color_name = "--magenta --bold ";
+        color_code = "\\033[1;35m";
         break;
       case EchoBuild:
         color_name = "--green ";
+        color_code = "\\033[32m";
         break;
       case EchoLink:
         color_name = "--green --bold ";
+        color_code = "\\033[1;32m";
         break;
       case EchoGenerate:
         color_name = "--blue --bold ";
+        color_code = "\\033[1;34m";
         break;
       case EchoGlobal:
         color_name = "--cyan ";
+        color_code = "\\033[36m";
         break;
       }
     }
@@ -1335,6 +1670,35 @@ cmLocalUnixMakefileGenerator3::AppendEcho(std::vector<std::string>& commands,
           cmd = "@echo ";
           cmd += this->EscapeForShell(line, false, true);
           }
+        else if(this->NativeEcho)
+          {
+          // Use the shell's printf builtin with the progress percentage
+          // computed at generate time.
+          std::string format = progress? "[%3d%%] %s" : "%s";
+          std::string args = " ";
+          if(progress)
+            {
+            args += progress->Arg;
+            args += " ";
+            }
+          args += this->EscapeForShell(line, false, true);
+          std::string plain = "printf '" + format + "\\n'" + args;
+          if(*color_code)
+            {
+            cmd = "@if test -t 1; then printf '";
+            cmd += color_code;
+            cmd += format;
+            cmd += "\\033[0m\\n'";
+            cmd += args;
+            cmd += "; else ";
+            cmd += plain;
+            cmd += "; fi";
+            }
+          else
+            {
+            cmd = "@" + plain;
+            }
+          }
         else
           {
           // Use cmake to echo the text in color.
@@ -1545,6 +1909,8 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(const char* tgtInfo,
     cmDependsC checker;
     checker.SetVerbose(verbose);
     checker.SetFileComparison(ftc);
+    checker.SetRescanNewerDependees(
+      this->Makefile->IsOn("CMAKE_DEPENDS_BATCH"));
     // cmDependsC::Check() fills the vector validDependencies() with the
     // dependencies for those files where they are still valid, i.e. neither
     // the files themselves nor any files they depend on have changed.
@@ -1989,6 +2355,138 @@ void cmLocalUnixMakefileGenerator3::ClearDependencies(cmMakefile* mf,
     }
 }
 
+//----------------------------------------------------------------------------
+static bool cmLocalUnixMakefileGeneratorDependeeOkay(
+  cmFileTimeComparison* ftc, std::string const& dependFile,
+  std::string const& dependee, bool verbose)
+{
+  int result = 0;
+  if(ftc->FileTimeCompare(dependFile.c_str(), dependee.c_str(), &result) &&
+     result >= 0)
+    {
+    return true;
+    }
+  if(verbose)
+    {
+    std::ostringstream msg;
+    msg << "Dependee \"" << dependee
+        << "\" is missing or newer than depends file \""
+        << dependFile << "\"." << std::endl;
+    cmSystemTools::Stdout(msg.str().c_str());
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+static bool cmLocalUnixMakefileGeneratorDependsValid(
+  std::string const& dir, cmFileTimeComparison* ftc, bool verbose)
+{
+  // The target and directory information must be older than the
+  // dependencies.
+  std::string internalDependFile = dir + "/depend.internal";
+  std::string dirInfoFile = cmSystemTools::GetFilenamePath(dir);
+  dirInfoFile += "/CMakeDirectoryInformation.cmake";
+  if(!cmLocalUnixMakefileGeneratorDependeeOkay(ftc, internalDependFile,
+                                               dir + "/DependInfo.cmake",
+                                               verbose) ||
+     !cmLocalUnixMakefileGeneratorDependeeOkay(ftc, internalDependFile,
+                                               dirInfoFile, verbose))
+    {
+    return false;
+    }
+
+  // So must every dependee.  Comparing against depend.internal rather
+  // than the depender also notices dependees regenerated after the
+  // dependencies were scanned.
+  cmsys::ifstream fin(internalDependFile.c_str());
+  std::string line;
+  while(cmSystemTools::GetLineFromStream(fin, line))
+    {
+    if(line.empty() || line[0] == '#')
+      {
+      continue;
+      }
+    if(line[0] == ' ')
+      {
+      if(line.size() > 1 &&
+         !cmLocalUnixMakefileGeneratorDependeeOkay(ftc, internalDependFile,
+                                                   line.substr(1), verbose))
+        {
+        return false;
+        }
+      continue;
+      }
+
+    // Dependencies written by the compiler for the depender after
+    // they were last read must be read again.
+    std::string depfile = line + ".d";
+    int result = 0;
+    if(ftc->FileTimeCompare(internalDependFile.c_str(), depfile.c_str(),
+                            &result) && result <= 0)
+      {
+      if(verbose)
+        {
+        std::ostringstream msg;
+        msg << "Dependency file \"" << depfile
+            << "\" is not older than depends file \""
+            << internalDependFile << "\"." << std::endl;
+        cmSystemTools::Stdout(msg.str().c_str());
+        }
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmLocalUnixMakefileGenerator3::CheckDependencies(cmMakefile* mf,
+                                                      bool verbose)
+{
+  // Get the list of target files to check
+  const char* infoDef = mf->GetDefinition("CMAKE_DEPEND_INFO_FILES");
+  if(!infoDef)
+    {
+    return;
+    }
+  std::vector<std::string> files;
+  cmSystemTools::ExpandListArgument(infoDef, files);
+
+  // Mark each target whose dependencies are up to date so that its
+  // depend rule need not run cmake_depends.  Dependencies of the other
+  // targets are scanned by their depend rules as usual, once the
+  // targets they depend on have been built.
+  cmFileTimeComparison* ftc =
+    this->GlobalGenerator->GetCMakeInstance()->GetFileComparison();
+  for(std::vector<std::string>::iterator l = files.begin();
+      l != files.end(); ++l)
+    {
+    std::string dir = cmSystemTools::GetFilenamePath(*l);
+    std::string validFile = dir + "/depend.valid";
+    if(cmLocalUnixMakefileGeneratorDependsValid(dir, ftc, verbose))
+      {
+      cmSystemTools::Touch(validFile, true);
+      }
+    else
+      {
+      cmSystemTools::RemoveFile(validFile);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+std::string
+cmLocalUnixMakefileGenerator3
+::GetCompilerDependsFlags(const std::string& lang) const
+{
+  // Only the C dependency scanner reads the files written by the
+  // compiler.  It scans the sources of other compilers as before.
+  if(!this->CompilerDepends || (lang != "C" && lang != "CXX"))
+    {
+    return "";
+    }
+  return this->Makefile->GetSafeDefinition(
+    "CMAKE_MAKEFILE_DEPFILE_FLAGS_" + lang);
+}
 
 void cmLocalUnixMakefileGenerator3
 ::WriteDependLanguageInfo(std::ostream& cmakefileStream, cmTarget &target)
@@ -2043,6 +2541,14 @@ void cmLocalUnixMakefileGenerator3
         << cid << "\")\n";
       }
 
+    // Tell the dependency scanner whether the compiler writes the
+    // dependencies of the object files.
+    if(!this->GetCompilerDependsFlags(l->first).empty())
+      {
+      cmakefileStream
+        << "set(CMAKE_DEPENDS_USE_COMPILER_" << l->first << " ON)\n";
+      }
+
     // Build a list of preprocessor definitions for the target.
     std::set<std::string> defines;
     this->AddCompileDefinitions(defines, &target,
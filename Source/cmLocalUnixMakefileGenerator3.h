@@ -181,6 +181,16 @@ public:
   /** Get whether the makefile is to have color.  */
   bool GetColorMakefile() const { return this->ColorMakefile; }
 
+  /** Get whether echo commands are run by the shell alone.  */
+  bool GetNativeEcho() const { return this->NativeEcho; }
+
+  /** Get whether target dependencies are checked by one process.  */
+  bool GetBatchDepends() const { return this->BatchDepends; }
+
+  /** Get the flags telling the compiler to write the dependencies of
+      an object file of the given language, if it is to do so.  */
+  std::string GetCompilerDependsFlags(const std::string& lang) const;
+
   virtual std::string GetTargetDirectory(cmTarget const& target) const;
 
     // create a command that cds to the start dir then runs the commands
@@ -202,6 +212,10 @@ public:
   /** Called from command-line hook to clear dependencies.  */
   virtual void ClearDependencies(cmMakefile* mf, bool verbose);
 
+  /** Called from command-line hook to check dependencies of all
+      targets at once.  */
+  virtual void CheckDependencies(cmMakefile* mf, bool verbose);
+
   /** write some extra rules such as make test etc */
   void WriteSpecialTargetsTop(std::ostream& makefileStream);
   void WriteSpecialTargetsBottom(std::ostream& makefileStream);
@@ -311,6 +325,19 @@ protected:
                 std::map<std::string, cmDepends::DependencyVector>& validDeps);
   void CheckMultipleOutputs(bool verbose);
 
+  // Helper methods for skipping directories whose inputs did not change.
+  typedef std::vector<std::pair<std::string, unsigned long> >
+    TargetProgressVector;
+  std::string GetFingerprintFileName();
+  std::string ComputeFingerprint();
+  void AppendTargetFingerprint(std::ostream& os, cmGeneratorTarget* gt);
+  void AppendCustomCommandFingerprint(std::ostream& os,
+                                      cmCustomCommand const& cc,
+                                      cmTarget* target);
+  bool ReuseFingerprintFile(std::string const& fingerprint);
+  void WriteFingerprintFile(std::string const& fingerprint,
+                            TargetProgressVector const& progress);
+
 private:
   std::string ConvertShellCommand(std::string const& cmd, RelativeRoot root);
   std::string MakeLauncher(cmCustomCommandGenerator const& ccg,
@@ -347,12 +374,29 @@ private:
      beginning of generation to avoid many duplicate lookups.  */
   bool ColorMakefile;
 
+  /* Copy the setting of CMAKE_MAKEFILE_NATIVE_ECHO from the makefile at
+     the beginning of generation.  It is ignored for Windows shells.  */
+  bool NativeEcho;
+
+  /* Copy the setting of CMAKE_MAKEFILE_BATCH_DEPENDS from the makefile
+     at the beginning of generation.  It is ignored for Windows shells.  */
+  bool BatchDepends;
+
+  /* Copy the setting of CMAKE_MAKEFILE_COMPILER_DEPENDS from the
+     makefile at the beginning of generation.  */
+  bool CompilerDepends;
+
   /* Copy the setting of CMAKE_SKIP_PREPROCESSED_SOURCE_RULES and
      CMAKE_SKIP_ASSEMBLY_SOURCE_RULES at the beginning of generation to
      avoid many duplicate lookups.  */
   bool SkipPreprocessedSourceRules;
   bool SkipAssemblySourceRules;
 
+  /* Copy the setting of CMAKE_MAKEFILE_SKIP_UNCHANGED_DIRECTORIES at the
+     beginning of generation.  It is ignored for the top directory and
+     when compile commands are exported.  */
+  bool SkipUnchanged;
+
   struct LocalObjectEntry
   {
     cmTarget* Target;
@@ -13,14 +13,175 @@
 
 #include "cmake.h"
 
+// A reference in a macro body argument that is replaced on invocation.
+struct cmMacroSlot
+{
+  enum SlotType { Formal, Argc, Argn, Argv, ArgvN };
+  SlotType Type;
+  unsigned int Index;
+};
+
+// A macro body argument split into literal text surrounding the slots
+// replaced by the invocation arguments.  There is always one more
+// literal than there are slots.
+struct cmMacroArgumentTemplate
+{
+  std::vector<std::string> Literals;
+  std::vector<cmMacroSlot> Slots;
+  // A literal leaves a "${" open across a slot, so a replacement could
+  // complete it into a new reference.
+  bool Nested;
+};
+
+// The recorded definition of a macro.  It is shared by the command
+// prototype and every clone invoked from it and is never modified after
+// the macro is defined.  The last command referencing it frees it.
+struct cmMacroHelperBody
+{
+  cmMacroHelperBody(): RefCount(1), Compiled(false) {}
+  unsigned int RefCount;
+  std::vector<std::string> Args;
+  std::vector<cmListFileFunction> Functions;
+  cmPolicies::PolicyMap Policies;
+
+  // The templates for each argument of each function, valid if Compiled.
+  std::vector<std::vector<cmMacroArgumentTemplate> > Templates;
+  bool Compiled;
+
+  void Compile();
+  bool LookupSlot(std::string const& name, cmMacroSlot& slot) const;
+};
+
+//----------------------------------------------------------------------------
+bool cmMacroHelperBody::LookupSlot(std::string const& name,
+                                   cmMacroSlot& slot) const
+{
+  // The formal arguments are replaced first so they take precedence.
+  for(unsigned int j = 1; j < this->Args.size(); ++j)
+    {
+    if(name == this->Args[j])
+      {
+      slot.Type = cmMacroSlot::Formal;
+      slot.Index = j - 1;
+      return true;
+      }
+    }
+  slot.Index = 0;
+  if(name == "ARGC")
+    {
+    slot.Type = cmMacroSlot::Argc;
+    }
+  else if(name == "ARGN")
+    {
+    slot.Type = cmMacroSlot::Argn;
+    }
+  else if(name == "ARGV")
+    {
+    slot.Type = cmMacroSlot::Argv;
+    }
+  else if(name.size() > 4 && name.size() < 14 &&
+          name.compare(0, 4, "ARGV") == 0 &&
+          (name[4] != '0' || name.size() == 5) &&
+          name.find_first_not_of("0123456789", 4) == name.npos)
+    {
+    // Only the spelling produced by formatting the index matches.
+    slot.Type = cmMacroSlot::ArgvN;
+    slot.Index = static_cast<unsigned int>(atoi(name.c_str() + 4));
+    }
+  else
+    {
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+static bool cmMacroHelperOpensReference(std::string const& literal)
+{
+  // A trailing "$" may be joined with a "{" following the slot.
+  if(!literal.empty() && literal[literal.size() - 1] == '$')
+    {
+    return true;
+    }
+  std::string::size_type pos = literal.rfind("${");
+  return pos != std::string::npos &&
+    literal.find('}', pos + 2) == std::string::npos;
+}
+
+//----------------------------------------------------------------------------
+void cmMacroHelperBody::Compile()
+{
+  // Formal names that could themselves form part of a reference cannot
+  // be located in advance, so such macros are always substituted the
+  // slow way.
+  for(unsigned int j = 1; j < this->Args.size(); ++j)
+    {
+    if(this->Args[j].find_first_of("${}") != std::string::npos)
+      {
+      return;
+      }
+    }
+
+  this->Templates.resize(this->Functions.size());
+  for(unsigned int c = 0; c < this->Functions.size(); ++c)
+    {
+    std::vector<cmListFileArgument> const& args =
+      this->Functions[c].Arguments;
+    this->Templates[c].resize(args.size());
+    for(unsigned int k = 0; k < args.size(); ++k)
+      {
+      cmMacroArgumentTemplate& t = this->Templates[c][k];
+      std::string const& value = args[k].Value;
+      std::string::size_type lit = 0;
+      std::string::size_type pos = 0;
+      t.Nested = false;
+      while((pos = value.find("${", pos)) != std::string::npos)
+        {
+        std::string::size_type end = value.find('}', pos + 2);
+        if(end == std::string::npos)
+          {
+          break;
+          }
+        cmMacroSlot slot;
+        if(this->LookupSlot(value.substr(pos + 2, end - pos - 2), slot))
+          {
+          t.Literals.push_back(value.substr(lit, pos - lit));
+          t.Slots.push_back(slot);
+          t.Nested = t.Nested ||
+            cmMacroHelperOpensReference(t.Literals.back());
+          pos = lit = end + 1;
+          }
+        else
+          {
+          ++pos;
+          }
+        }
+      t.Literals.push_back(value.substr(lit));
+      if(t.Slots.empty())
+        {
+        // Every invocation copies the argument, so the copies must share
+        // its parsed form to be expanded from it.
+        args[k].ShareTokens();
+        }
+      }
+    }
+  this->Compiled = true;
+}
+
 // define the class for macro commands
 class cmMacroHelperCommand : public cmCommand
 {
 public:
-  cmMacroHelperCommand() {}
+  cmMacroHelperCommand(cmMacroHelperBody* body): Body(body) {}
 
   ///! clean up any memory allocated by the macro
-  ~cmMacroHelperCommand() {}
+  ~cmMacroHelperCommand()
+    {
+    if(--this->Body->RefCount == 0)
+      {
+      delete this->Body;
+      }
+    }
 
   /**
    * This is used to avoid including this command
@@ -38,13 +199,10 @@ public:
    */
   virtual cmCommand* Clone()
   {
-    cmMacroHelperCommand *newC = new cmMacroHelperCommand;
-    // we must copy when we clone
-    newC->Args = this->Args;
-    newC->Functions = this->Functions;
-    newC->FilePath = this->FilePath;
-    newC->Policies = this->Policies;
-    return newC;
+    // The clone shares the body so that it stays alive even if the
+    // macro is redefined while it is executing.
+    ++this->Body->RefCount;
+    return new cmMacroHelperCommand(this->Body);
   }
 
   /**
@@ -65,14 +223,18 @@ public:
   /**
    * The name of the command as specified in CMakeList.txt.
    */
-  virtual std::string GetName() const { return this->Args[0]; }
+  virtual std::string GetName() const { return this->Body->Args[0]; }
 
   cmTypeMacro(cmMacroHelperCommand, cmCommand);
 
-  std::vector<std::string> Args;
-  std::vector<cmListFileFunction> Functions;
-  cmPolicies::PolicyMap Policies;
-  std::string FilePath;
+private:
+  void ReplaceArguments(std::string& value,
+                        std::vector<std::string> const& expandedArgs,
+                        std::string const& argcDef,
+                        std::string const& expandedArgn,
+                        std::string const& expandedArgv);
+
+  cmMacroHelperBody* Body;
 };
 
 
@@ -86,11 +248,11 @@ bool cmMacroHelperCommand::InvokeInitialPass
 
   // make sure the number of arguments passed is at least the number
   // required by the signature
-  if (expandedArgs.size() < this->Args.size() - 1)
+  if (expandedArgs.size() < this->Body->Args.size() - 1)
     {
     std::string errorMsg =
       "Macro invoked with incorrect arguments for macro named: ";
-    errorMsg += this->Args[0];
+    errorMsg += this->Body->Args[0];
     this->SetError(errorMsg);
     return false;
     }
@@ -100,7 +262,8 @@ bool cmMacroHelperCommand::InvokeInitialPass
 
   // Push a weak policy scope which restores the policies recorded at
   // macro creation.
-  cmMakefile::PolicyPushPop polScope(this->Makefile, true, this->Policies);
+  cmMakefile::PolicyPushPop polScope(this->Makefile, true,
+                                     this->Body->Policies);
 
   // set the value of argc
   std::ostringstream argcDefStream;
@@ -108,81 +271,117 @@ bool cmMacroHelperCommand::InvokeInitialPass
   std::string argcDef = argcDefStream.str();
 
   std::vector<std::string>::const_iterator eit
-      = expandedArgs.begin() + (this->Args.size() - 1);
+      = expandedArgs.begin() + (this->Body->Args.size() - 1);
   std::string expandedArgn = cmJoin(cmRange(eit, expandedArgs.end()), ";");
   std::string expandedArgv = cmJoin(expandedArgs, ";");
-  std::vector<std::string> variables;
-  variables.reserve(this->Args.size() - 1);
-  for (unsigned int j = 1; j < this->Args.size(); ++j)
-    {
-    variables.push_back("${" + this->Args[j] + "}");
-    }
-  std::vector<std::string> argVs;
-  argVs.reserve(expandedArgs.size());
-  char argvName[60];
+
+  // Values containing a reference delimiter may form new references
+  // with the surrounding text, which only the sequential replacement
+  // below handles faithfully.
+  std::vector<bool> unsafe(expandedArgs.size(), false);
+  bool argnUnsafe = false;
+  bool argvUnsafe = false;
   for (unsigned int j = 0; j < expandedArgs.size(); ++j)
     {
-    sprintf(argvName,"${ARGV%i}",j);
-    argVs.push_back(argvName);
-    }
-  if(!this->Functions.empty())
-    {
-    this->FilePath = this->Functions[0].FilePath;
+    if(expandedArgs[j].find_first_of("${") != std::string::npos)
+      {
+      unsafe[j] = true;
+      argvUnsafe = true;
+      argnUnsafe = argnUnsafe || j + 1 >= this->Body->Args.size();
+      }
     }
+
   // Invoke all the functions that were collected in the block.
   cmListFileFunction newLFF;
   // for each function
-  for(unsigned int c = 0; c < this->Functions.size(); ++c)
+  for(unsigned int c = 0; c < this->Body->Functions.size(); ++c)
     {
     // Replace the formal arguments and then invoke the command.
     newLFF.Arguments.clear();
-    newLFF.Arguments.reserve(this->Functions[c].Arguments.size());
-    newLFF.Name = this->Functions[c].Name;
-    newLFF.FilePath = this->Functions[c].FilePath;
-    newLFF.Line = this->Functions[c].Line;
+    newLFF.Arguments.reserve(this->Body->Functions[c].Arguments.size());
+    newLFF.Name = this->Body->Functions[c].Name;
+    newLFF.FilePath = this->Body->Functions[c].FilePath;
+    newLFF.Line = this->Body->Functions[c].Line;
 
     // for each argument of the current function
-    for (std::vector<cmListFileArgument>::iterator k =
-           this->Functions[c].Arguments.begin();
-         k != this->Functions[c].Arguments.end(); ++k)
+    std::vector<cmListFileArgument> const& bodyArgs =
+      this->Body->Functions[c].Arguments;
+    for (unsigned int k = 0; k < bodyArgs.size(); ++k)
       {
-      // Set the FilePath on the arguments to match the function since it is
-      // not stored and the original values may be freed
-      k->FilePath = this->FilePath.c_str();
+      cmListFileArgument const& bodyArg = bodyArgs[k];
+      if(bodyArg.Delim == cmListFileArgument::Bracket ||
+         (this->Body->Compiled && this->Body->Templates[c][k].Slots.empty()))
+        {
+        // Nothing to replace, so the argument keeps its parsed form.
+        newLFF.Arguments.push_back(bodyArg);
+        continue;
+        }
+      newLFF.Arguments.push_back(cmListFileArgument());
+      cmListFileArgument& arg = newLFF.Arguments.back();
+      arg.Delim = bodyArg.Delim;
+      arg.FilePath = bodyArg.FilePath;
+      arg.Line = bodyArg.Line;
+      if(!this->Body->Compiled)
+        {
+        arg.Value = bodyArg.Value;
+        this->ReplaceArguments(arg.Value, expandedArgs, argcDef,
+                               expandedArgn, expandedArgv);
+        continue;
+        }
 
-      cmListFileArgument arg;
-      arg.Value = k->Value;
-      if(k->Delim != cmListFileArgument::Bracket)
+      cmMacroArgumentTemplate const& t = this->Body->Templates[c][k];
+      bool slow = t.Nested;
+      for(std::vector<cmMacroSlot>::const_iterator si = t.Slots.begin();
+          !slow && si != t.Slots.end(); ++si)
         {
-        // replace formal arguments
-        for (unsigned int j = 0; j < variables.size(); ++j)
+        switch(si->Type)
           {
-          cmSystemTools::ReplaceString(arg.Value, variables[j].c_str(),
-                                       expandedArgs[j].c_str());
+          case cmMacroSlot::Formal:
+          case cmMacroSlot::ArgvN:
+            slow = si->Index < unsafe.size() && unsafe[si->Index];
+            break;
+          case cmMacroSlot::Argn: slow = argnUnsafe; break;
+          case cmMacroSlot::Argv: slow = argvUnsafe; break;
+          case cmMacroSlot::Argc: break;
           }
-        // replace argc
-        cmSystemTools::ReplaceString(arg.Value, "${ARGC}",argcDef.c_str());
-
-        cmSystemTools::ReplaceString(arg.Value, "${ARGN}",
-                                     expandedArgn.c_str());
-        cmSystemTools::ReplaceString(arg.Value, "${ARGV}",
-                                     expandedArgv.c_str());
+        }
+      if(slow)
+        {
+        arg.Value = bodyArg.Value;
+        this->ReplaceArguments(arg.Value, expandedArgs, argcDef,
+                               expandedArgn, expandedArgv);
+        continue;
+        }
 
-        // if the current argument of the current function has ${ARGV in it
-        // then try replacing ARGV values
-        if (arg.Value.find("${ARGV") != std::string::npos)
+      // Fill the slots between the literal text.
+      for(unsigned int i = 0; i < t.Slots.size(); ++i)
+        {
+        arg.Value += t.Literals[i];
+        cmMacroSlot const& slot = t.Slots[i];
+        switch(slot.Type)
           {
-          for (unsigned int t = 0; t < expandedArgs.size(); ++t)
-            {
-            cmSystemTools::ReplaceString(arg.Value, argVs[t].c_str(),
-                                         expandedArgs[t].c_str());
-            }
+          case cmMacroSlot::Formal:
+            arg.Value += expandedArgs[slot.Index];
+            break;
+          case cmMacroSlot::Argc: arg.Value += argcDef; break;
+          case cmMacroSlot::Argn: arg.Value += expandedArgn; break;
+          case cmMacroSlot::Argv: arg.Value += expandedArgv; break;
+          case cmMacroSlot::ArgvN:
+            if(slot.Index < expandedArgs.size())
+              {
+              arg.Value += expandedArgs[slot.Index];
+              }
+            else
+              {
+              // There is no such argument so the reference is kept.
+              std::ostringstream ref;
+              ref << "${ARGV" << slot.Index << "}";
+              arg.Value += ref.str();
+              }
+            break;
           }
         }
-      arg.Delim = k->Delim;
-      arg.FilePath = k->FilePath;
-      arg.Line = k->Line;
-      newLFF.Arguments.push_back(arg);
+      arg.Value += t.Literals.back();
       }
     cmExecutionStatus status;
     if(!this->Makefile->ExecuteCommand(newLFF, status) ||
@@ -209,6 +408,39 @@ bool cmMacroHelperCommand::InvokeInitialPass
   return true;
 }
 
+//----------------------------------------------------------------------------
+void cmMacroHelperCommand::ReplaceArguments(
+  std::string& value, std::vector<std::string> const& expandedArgs,
+  std::string const& argcDef, std::string const& expandedArgn,
+  std::string const& expandedArgv)
+{
+  // replace formal arguments
+  for (unsigned int j = 1; j < this->Body->Args.size(); ++j)
+    {
+    std::string variable = "${" + this->Body->Args[j] + "}";
+    cmSystemTools::ReplaceString(value, variable.c_str(),
+                                 expandedArgs[j - 1].c_str());
+    }
+  // replace argc
+  cmSystemTools::ReplaceString(value, "${ARGC}",argcDef.c_str());
+
+  cmSystemTools::ReplaceString(value, "${ARGN}", expandedArgn.c_str());
+  cmSystemTools::ReplaceString(value, "${ARGV}", expandedArgv.c_str());
+
+  // if the current argument of the current function has ${ARGV in it
+  // then try replacing ARGV values
+  if (value.find("${ARGV") != std::string::npos)
+    {
+    char argvName[60];
+    for (unsigned int t = 0; t < expandedArgs.size(); ++t)
+      {
+      sprintf(argvName,"${ARGV%i}",t);
+      cmSystemTools::ReplaceString(value, argvName,
+                                   expandedArgs[t].c_str());
+      }
+    }
+}
+
 bool cmMacroFunctionBlocker::
 IsFunctionBlocked(const cmListFileFunction& lff, cmMakefile &mf,
                   cmExecutionStatus &)
@@ -226,10 +458,24 @@ IsFunctionBlocked(const cmListFileFunction& lff, cmMakefile &mf,
       {
       mf.AddMacro(this->Args[0].c_str());
       // create a new command and add it to cmake
-      cmMacroHelperCommand *f = new cmMacroHelperCommand();
-      f->Args = this->Args;
-      f->Functions = this->Functions;
-      mf.RecordPolicies(f->Policies);
+      cmMacroHelperBody *body = new cmMacroHelperBody;
+      body->Args = this->Args;
+      body->Functions = this->Functions;
+      mf.RecordPolicies(body->Policies);
+
+      // Set the FilePath on the arguments to match the macro since it is
+      // not stored and the original values may be freed
+      for (unsigned int i = 0; i < body->Functions.size(); ++i)
+        {
+        for (unsigned int j = 0; j < body->Functions[i].Arguments.size();
+             ++j)
+          {
+          body->Functions[i].Arguments[j].FilePath =
+            body->Functions[i].FilePath.c_str();
+          }
+        }
+      body->Compile();
+      cmMacroHelperCommand *f = new cmMacroHelperCommand(body);
       std::string newName = "_" + this->Args[0];
       mf.GetCMakeInstance()->RenameCommand(this->Args[0],
                                            newName);
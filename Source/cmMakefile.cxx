@@ -21,6 +21,7 @@
 #include "cmCacheManager.h"
 #include "cmFunctionBlocker.h"
 #include "cmListFileCache.h"
+#include "cmMakefileProfilingData.h"
 #include "cmCommandArgumentParserHelper.h"
 #include "cmGeneratorExpression.h"
 #include "cmTest.h"
@@ -38,16 +39,145 @@
 #include <cmsys/auto_ptr.hxx>
 
 #include <stack>
+#include <deque>
 #include <list>
 #include <ctype.h> // for isspace
 #include <assert.h>
 
+// Record which variables have been initialized and used for the
+// unused and uninitialized variable warnings.  Each function scope
+// stores only its changes relative to the enclosing scope.
+class cmMakefileVariableUsage
+{
+public:
+  cmMakefileVariableUsage(): Scopes(1) {}
+
+  // Copy the state visible in the current scope of another instance.
+  void InitializeFrom(cmMakefileVariableUsage const& other);
+
+  void PushScope() { this->Scopes.push_back(Scope()); }
+  void PopScope(std::set<std::string> const& locals,
+                std::set<std::string> const& usedLocals);
+
+  void SetInitialized(const std::string& var)
+    { this->Scopes.back().Initialized.insert(var); }
+  bool IsInitialized(const std::string& var) const;
+
+  void SetUsed(const std::string& var)
+    {
+    Scope& scope = this->Scopes.back();
+    scope.Used.insert(var);
+    scope.Unused.erase(var);
+    }
+  void SetUnused(const std::string& var)
+    {
+    Scope& scope = this->Scopes.back();
+    scope.Used.erase(var);
+    if(this->Scopes.size() > 1)
+      {
+      scope.Unused.insert(var);
+      }
+    }
+  bool IsUsed(const std::string& var) const;
+
+private:
+  struct Scope
+  {
+    std::set<std::string> Initialized;
+    std::set<std::string> Used;
+    // Variables used in an enclosing scope but not in this one.
+    std::set<std::string> Unused;
+  };
+  std::deque<Scope> Scopes;
+};
+
+//----------------------------------------------------------------------------
+void
+cmMakefileVariableUsage::InitializeFrom(cmMakefileVariableUsage const& other)
+{
+  Scope flat;
+  for(std::deque<Scope>::const_iterator si = other.Scopes.begin();
+      si != other.Scopes.end(); ++si)
+    {
+    flat.Initialized.insert(si->Initialized.begin(), si->Initialized.end());
+    for(std::set<std::string>::const_iterator vi = si->Unused.begin();
+        vi != si->Unused.end(); ++vi)
+      {
+      flat.Used.erase(*vi);
+      }
+    flat.Used.insert(si->Used.begin(), si->Used.end());
+    }
+  this->Scopes.clear();
+  this->Scopes.push_back(flat);
+}
+
+//----------------------------------------------------------------------------
+void cmMakefileVariableUsage::PopScope(std::set<std::string> const& locals,
+                                       std::set<std::string> const& used)
+{
+  // Push initialization and usage up to the parent scope except for
+  // variables local to the scope being removed.  Usage removed in the
+  // inner scope is not propagated.
+  Scope inner;
+  inner.Initialized.swap(this->Scopes.back().Initialized);
+  inner.Used.swap(this->Scopes.back().Used);
+  this->Scopes.pop_back();
+  for(std::set<std::string>::const_iterator it = inner.Initialized.begin();
+      it != inner.Initialized.end(); ++it)
+    {
+    if(locals.find(*it) == locals.end())
+      {
+      this->SetInitialized(*it);
+      }
+    }
+  for(std::set<std::string>::const_iterator it = inner.Used.begin();
+      it != inner.Used.end(); ++it)
+    {
+    if(used.find(*it) == used.end())
+      {
+      this->SetUsed(*it);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmMakefileVariableUsage::IsInitialized(const std::string& var) const
+{
+  for(std::deque<Scope>::const_reverse_iterator si = this->Scopes.rbegin();
+      si != this->Scopes.rend(); ++si)
+    {
+    if(si->Initialized.find(var) != si->Initialized.end())
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool cmMakefileVariableUsage::IsUsed(const std::string& var) const
+{
+  for(std::deque<Scope>::const_reverse_iterator si = this->Scopes.rbegin();
+      si != this->Scopes.rend(); ++si)
+    {
+    if(si->Used.find(var) != si->Used.end())
+      {
+      return true;
+      }
+    if(si->Unused.find(var) != si->Unused.end())
+      {
+      return false;
+      }
+    }
+  return false;
+}
+
 class cmMakefile::Internals
 {
 public:
   std::stack<cmDefinitions, std::list<cmDefinitions> > VarStack;
-  std::stack<std::set<std::string> > VarInitStack;
-  std::stack<std::set<std::string> > VarUsageStack;
+  // Only present when unused or uninitialized variables are diagnosed.
+  cmsys::auto_ptr<cmMakefileVariableUsage> VarUsage;
   bool IsSourceFileTryCompile;
 };
 
@@ -55,10 +185,9 @@ public:
 cmMakefile::cmMakefile(): Internal(new Internals)
 {
   const cmDefinitions& defs = cmDefinitions();
-  const std::set<std::string> globalKeys = defs.LocalKeys();
   this->Internal->VarStack.push(defs);
-  this->Internal->VarInitStack.push(globalKeys);
-  this->Internal->VarUsageStack.push(globalKeys);
+  // Track usage until SetLocalGenerator knows whether it is needed.
+  this->Internal->VarUsage.reset(new cmMakefileVariableUsage);
   this->Internal->IsSourceFileTryCompile = false;
 
   // Initialize these first since AddDefaultDefinitions calls AddDefinition
@@ -109,8 +238,11 @@ cmMakefile::cmMakefile(): Internal(new Internals)
 cmMakefile::cmMakefile(const cmMakefile& mf): Internal(new Internals)
 {
   this->Internal->VarStack.push(mf.Internal->VarStack.top().Closure());
-  this->Internal->VarInitStack.push(mf.Internal->VarInitStack.top());
-  this->Internal->VarUsageStack.push(mf.Internal->VarUsageStack.top());
+  if(mf.Internal->VarUsage.get())
+    {
+    this->Internal->VarUsage.reset(new cmMakefileVariableUsage);
+    this->Internal->VarUsage->InitializeFrom(*mf.Internal->VarUsage);
+    }
 
   this->Prefix = mf.Prefix;
   this->AuxSourceDirectories = mf.AuxSourceDirectories;
@@ -122,6 +254,7 @@ cmMakefile::cmMakefile(const cmMakefile& mf): Internal(new Internals)
   this->ProjectName = mf.ProjectName;
   this->Targets = mf.Targets;
   this->SourceFiles = mf.SourceFiles;
+  this->SourceFileSearch = mf.SourceFileSearch;
   this->Tests = mf.Tests;
   this->LinkDirectories = mf.LinkDirectories;
   this->SystemIncludeDirectories = mf.SystemIncludeDirectories;
@@ -304,7 +437,7 @@ void cmMakefile::IssueMessage(cmake::MessageType t,
       lfc.FilePath = this->ListFileStack.back();
       }
     lfc.Line = 0;
-    backtrace.push_back(lfc);
+    backtrace = backtrace.Push(lfc);
     }
 
   // Issue the message.
@@ -314,11 +447,22 @@ void cmMakefile::IssueMessage(cmake::MessageType t,
 //----------------------------------------------------------------------------
 cmListFileBacktrace cmMakefile::GetBacktrace() const
 {
+  // Extend the innermost backtrace already created on the call stack so
+  // that all backtraces taken under the same callers share their frames.
+  CallStackType::const_iterator i = this->CallStack.end();
+  while(i != this->CallStack.begin() && (i-1)->Backtrace.Empty())
+    {
+    --i;
+    }
   cmListFileBacktrace backtrace(this->GetLocalGenerator());
-  for(CallStackType::const_reverse_iterator i = this->CallStack.rbegin();
-      i != this->CallStack.rend(); ++i)
+  if(i != this->CallStack.begin())
+    {
+    backtrace = (i-1)->Backtrace;
+    }
+  for(; i != this->CallStack.end(); ++i)
     {
-    backtrace.push_back(*i->Context);
+    backtrace = backtrace.Push(*i->Context);
+    i->Backtrace = backtrace;
     }
   return backtrace;
 }
@@ -358,11 +502,26 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
   cmMakefileCall stack_manager(this, lff, status);
   static_cast<void>(stack_manager);
 
+  // Record the time spent in the command when profiling.
+  cmMakefileProfilingData::Scope profilingScope(
+    this->GetCMakeInstance()->GetProfilingOutput(), lff);
+  static_cast<void>(profilingScope);
+
   // Lookup the command prototype.
   if(cmCommand* proto = this->GetCMakeInstance()->GetCommand(name))
     {
-    // Clone the prototype.
-    cmsys::auto_ptr<cmCommand> pcmd(proto->Clone());
+    // Clone the prototype unless the command keeps no state, in which
+    // case it is invoked directly.  Remember the makefile the prototype
+    // was set up for in case this is a nested invocation.
+    bool stateless = proto->IsStateless();
+    cmsys::auto_ptr<cmCommand> clone;
+    cmCommand* pcmd = proto;
+    cmMakefile* protoMakefile = proto->GetMakefile();
+    if(!stateless)
+      {
+      clone.reset(proto->Clone());
+      pcmd = clone.get();
+      }
     pcmd->SetMakefile(this);
 
     // Decide whether to invoke the command.
@@ -376,7 +535,12 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
         {
         this->PrintCommandTrace(lff);
         }
-      // Try invoking the command.
+      // Try invoking the command.  The prototype of a stateless command
+      // may still hold the error of its previous invocation.
+      if(stateless)
+        {
+        pcmd->ClearError();
+        }
       if(!pcmd->InvokeInitialPass(lff.Arguments,status) ||
          status.GetNestedError())
         {
@@ -391,10 +555,10 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
           cmSystemTools::SetFatalErrorOccured();
           }
         }
-      else if(pcmd->HasFinalPass())
+      else if(!stateless && pcmd->HasFinalPass())
         {
         // use the command
-        this->FinalPassCommands.push_back(pcmd.release());
+        this->FinalPassCommands.push_back(clone.release());
         }
       }
     else if ( this->GetCMakeInstance()->GetWorkingMode() == cmake::SCRIPT_MODE
@@ -407,6 +571,10 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
       result = false;
       cmSystemTools::SetFatalErrorOccured();
       }
+    if(stateless)
+      {
+      proto->SetMakefile(protoMakefile);
+      }
     }
   else
     {
@@ -762,6 +930,10 @@ void cmMakefile::SetLocalGenerator(cmLocalGenerator* lg)
 
   this->WarnUnused = this->GetCMakeInstance()->GetWarnUnused();
   this->CheckSystemVars = this->GetCMakeInstance()->GetCheckSystemVars();
+  if(!this->WarnUnused && !this->GetCMakeInstance()->GetWarnUninitialized())
+    {
+    this->Internal->VarUsage.reset();
+    }
 }
 
 namespace
@@ -1775,13 +1947,15 @@ void cmMakefile::AddDefinition(const std::string& name, const char* value)
     }
 
   this->Internal->VarStack.top().Set(name, value);
-  if (!this->Internal->VarUsageStack.empty() &&
-      this->VariableInitialized(name))
+  if (cmMakefileVariableUsage* usage = this->Internal->VarUsage.get())
     {
-    this->CheckForUnused("changing definition", name);
-    this->Internal->VarUsageStack.top().erase(name);
+    if (usage->IsInitialized(name))
+      {
+      this->CheckForUnused("changing definition", name);
+      usage->SetUnused(name);
+      }
+    usage->SetInitialized(name);
     }
-  this->Internal->VarInitStack.top().insert(name);
 
 #ifdef CMAKE_BUILD_WITH_CMAKE
   cmVariableWatch* vv = this->GetVariableWatch();
@@ -1850,13 +2024,15 @@ void cmMakefile::AddCacheDefinition(const std::string& name, const char* value,
 void cmMakefile::AddDefinition(const std::string& name, bool value)
 {
   this->Internal->VarStack.top().Set(name, value? "ON" : "OFF");
-  if (!this->Internal->VarUsageStack.empty() &&
-      this->VariableInitialized(name))
+  if (cmMakefileVariableUsage* usage = this->Internal->VarUsage.get())
     {
-    this->CheckForUnused("changing definition", name);
-    this->Internal->VarUsageStack.top().erase(name);
+    if (usage->IsInitialized(name))
+      {
+      this->CheckForUnused("changing definition", name);
+      usage->SetUnused(name);
+      }
+    usage->SetInitialized(name);
     }
-  this->Internal->VarInitStack.top().insert(name);
 #ifdef CMAKE_BUILD_WITH_CMAKE
   cmVariableWatch* vv = this->GetVariableWatch();
   if ( vv )
@@ -1884,27 +2060,22 @@ void cmMakefile::CheckForUnusedVariables() const
 
 void cmMakefile::MarkVariableAsUsed(const std::string& var)
 {
-  this->Internal->VarUsageStack.top().insert(var);
+  if (cmMakefileVariableUsage* usage = this->Internal->VarUsage.get())
+    {
+    usage->SetUsed(var);
+    }
 }
 
 bool cmMakefile::VariableInitialized(const std::string& var) const
 {
-  if(this->Internal->VarInitStack.top().find(var) !=
-      this->Internal->VarInitStack.top().end())
-    {
-    return true;
-    }
-  return false;
+  cmMakefileVariableUsage* usage = this->Internal->VarUsage.get();
+  return usage && usage->IsInitialized(var);
 }
 
 bool cmMakefile::VariableUsed(const std::string& var) const
 {
-  if(this->Internal->VarUsageStack.top().find(var) !=
-      this->Internal->VarUsageStack.top().end())
-    {
-    return true;
-    }
-  return false;
+  cmMakefileVariableUsage* usage = this->Internal->VarUsage.get();
+  return usage && usage->IsUsed(var);
 }
 
 void cmMakefile::CheckForUnused(const char* reason,
@@ -1917,7 +2088,7 @@ void cmMakefile::CheckForUnused(const char* reason,
     if (!this->CallStack.empty())
       {
       const cmListFileContext* file = this->CallStack.back().Context;
-      bt.push_back(*file);
+      bt = bt.Push(*file);
       path = file->FilePath.c_str();
       }
     else
@@ -1927,7 +2098,7 @@ void cmMakefile::CheckForUnused(const char* reason,
       cmListFileContext lfc;
       lfc.FilePath = path;
       lfc.Line = 0;
-      bt.push_back(lfc);
+      bt = bt.Push(lfc);
       }
     if (this->CheckSystemVars ||
         cmSystemTools::IsSubDirectory(path,
@@ -1949,13 +2120,15 @@ void cmMakefile::CheckForUnused(const char* reason,
 void cmMakefile::RemoveDefinition(const std::string& name)
 {
   this->Internal->VarStack.top().Set(name, 0);
-  if (!this->Internal->VarUsageStack.empty() &&
-      this->VariableInitialized(name))
+  if (cmMakefileVariableUsage* usage = this->Internal->VarUsage.get())
     {
-    this->CheckForUnused("unsetting", name);
-    this->Internal->VarUsageStack.top().erase(name);
+    if (usage->IsInitialized(name))
+      {
+      this->CheckForUnused("unsetting", name);
+      usage->SetUnused(name);
+      }
+    usage->SetInitialized(name);
     }
-  this->Internal->VarInitStack.top().insert(name);
 #ifdef CMAKE_BUILD_WITH_CMAKE
   cmVariableWatch* vv = this->GetVariableWatch();
   if ( vv )
@@ -2423,7 +2596,10 @@ const char* cmMakefile::GetRequiredDefinition(const std::string& name) const
 bool cmMakefile::IsDefinitionSet(const std::string& name) const
 {
   const char* def = this->Internal->VarStack.top().Get(name);
-  this->Internal->VarUsageStack.top().insert(name);
+  if (cmMakefileVariableUsage* usage = this->Internal->VarUsage.get())
+    {
+    usage->SetUsed(name);
+    }
   if(!def)
     {
     def = this->GetCacheManager()->GetCacheValue(name);
@@ -2446,7 +2622,7 @@ const char* cmMakefile::GetDefinition(const std::string& name) const
 {
   if (this->WarnUnused)
     {
-    this->Internal->VarUsageStack.top().insert(name);
+    this->Internal->VarUsage->SetUsed(name);
     }
   const char* def = this->Internal->VarStack.top().Get(name);
   if(!def)
@@ -2770,6 +2946,79 @@ struct t_lookup
   size_t loc;
   };
 
+//----------------------------------------------------------------------------
+// Compute the replacement of one closed ${}, $ENV{} or $CACHE{} reference.
+void cmMakefile::ExpandVariableReference(std::string& varresult,
+                                         int domain,
+                                         std::string const& lookup,
+                                         bool escapeQuotes,
+                                         const char* filename,
+                                         long line,
+                                         bool removeEmpty) const
+{
+  const char* value = NULL;
+  static const std::string lineVar = "CMAKE_CURRENT_LIST_LINE";
+  switch(domain)
+    {
+    case NORMAL:
+      if(filename && lookup == lineVar)
+        {
+        std::ostringstream ostr;
+        ostr << line;
+        varresult = ostr.str();
+        }
+      else
+        {
+        value = this->GetDefinition(lookup);
+        }
+      break;
+    case ENVIRONMENT:
+      value = cmSystemTools::GetEnv(lookup.c_str());
+      break;
+    case CACHE:
+      value = this->GetCacheManager()->GetCacheValue(lookup);
+      break;
+    }
+  // Get the string we're meant to append to.
+  if(value)
+    {
+    if(escapeQuotes)
+      {
+      varresult = cmSystemTools::EscapeQuotes(value);
+      }
+    else
+      {
+      varresult = value;
+      }
+    }
+  else if(!removeEmpty)
+    {
+    // check to see if we need to print a warning
+    // if strict mode is on and the variable has
+    // not been "cleared"/initialized with a set(foo ) call
+    if(this->GetCMakeInstance()->GetWarnUninitialized() &&
+       !this->VariableInitialized(lookup))
+      {
+      if (this->CheckSystemVars ||
+          cmSystemTools::IsSubDirectory(filename,
+                                        this->GetHomeDirectory()) ||
+          cmSystemTools::IsSubDirectory(filename,
+                                     this->GetHomeOutputDirectory()))
+        {
+        std::ostringstream msg;
+        cmListFileBacktrace bt(this->GetLocalGenerator());
+        cmListFileContext lfc;
+        lfc.FilePath = filename;
+        lfc.Line = line;
+        bt = bt.Push(lfc);
+        msg << "uninitialized variable \'" << lookup << "\'";
+        this->GetCMakeInstance()->IssueMessage(cmake::AUTHOR_WARNING,
+                                               msg.str(), bt);
+        }
+      }
+    }
+}
+
 cmake::MessageType cmMakefile::ExpandVariablesInStringNew(
                                             std::string& errorstr,
                                             std::string& source,
@@ -2808,68 +3057,10 @@ cmake::MessageType cmMakefile::ExpandVariablesInStringNew(
           openstack.pop();
           result.append(last, in - last);
           std::string const& lookup = result.substr(var.loc);
-          const char* value = NULL;
           std::string varresult;
-          static const std::string lineVar = "CMAKE_CURRENT_LIST_LINE";
-          switch(var.domain)
-            {
-            case NORMAL:
-              if(filename && lookup == lineVar)
-                {
-                std::ostringstream ostr;
-                ostr << line;
-                varresult = ostr.str();
-                }
-              else
-                {
-                value = this->GetDefinition(lookup);
-                }
-              break;
-            case ENVIRONMENT:
-              value = cmSystemTools::GetEnv(lookup.c_str());
-              break;
-            case CACHE:
-              value = this->GetCacheManager()->GetCacheValue(lookup);
-              break;
-            }
-          // Get the string we're meant to append to.
-          if(value)
-            {
-            if(escapeQuotes)
-              {
-              varresult = cmSystemTools::EscapeQuotes(value);
-              }
-            else
-              {
-              varresult = value;
-              }
-            }
-          else if(!removeEmpty)
-            {
-            // check to see if we need to print a warning
-            // if strict mode is on and the variable has
-            // not been "cleared"/initialized with a set(foo ) call
-            if(this->GetCMakeInstance()->GetWarnUninitialized() &&
-               !this->VariableInitialized(lookup))
-              {
-              if (this->CheckSystemVars ||
-                  cmSystemTools::IsSubDirectory(filename,
-                                                this->GetHomeDirectory()) ||
-                  cmSystemTools::IsSubDirectory(filename,
-                                             this->GetHomeOutputDirectory()))
-                {
-                std::ostringstream msg;
-                cmListFileBacktrace bt(this->GetLocalGenerator());
-                cmListFileContext lfc;
-                lfc.FilePath = filename;
-                lfc.Line = line;
-                bt.push_back(lfc);
-                msg << "uninitialized variable \'" << lookup << "\'";
-                this->GetCMakeInstance()->IssueMessage(cmake::AUTHOR_WARNING,
-                                                       msg.str(), bt);
-                }
-              }
-            }
+          this->ExpandVariableReference(varresult, var.domain, lookup,
+                                        escapeQuotes, filename, line,
+                                        removeEmpty);
           result.replace(var.loc, result.size() - var.loc, varresult);
           // Start looking from here on out.
           last = in + 1;
@@ -3079,6 +3270,254 @@ cmake::MessageType cmMakefile::ExpandVariablesInStringNew(
   return mtype;
 }
 
+//----------------------------------------------------------------------------
+bool cmMakefile::CompileArgumentTokens(std::string const& source,
+                                       cmListFileArgumentTokens& tokens) const
+{
+  // This follows ExpandVariablesInStringNew as called for a list file
+  // argument but records the literal text and the references instead of
+  // looking them up.  Anything it would diagnose is left to it.
+  typedef cmListFileArgumentTokens::Token Token;
+  const char* in = source.c_str();
+  const char* last = in;
+  std::string literal;
+  long line = 0;
+  int depth = 0;
+  bool done = false;
+  Token token;
+  token.Domain = NORMAL;
+  token.Line = 0;
+
+  do
+    {
+    char inc = *in;
+    switch(inc)
+      {
+      case '}':
+        if(depth > 0)
+          {
+          literal.append(last, in - last);
+          if(!literal.empty())
+            {
+            token.Type = cmListFileArgumentTokens::Literal;
+            token.Text = literal;
+            tokens.Tokens.push_back(token);
+            literal = "";
+            }
+          token.Type = cmListFileArgumentTokens::Close;
+          token.Text = "";
+          token.Line = line;
+          tokens.Tokens.push_back(token);
+          --depth;
+          last = in + 1;
+          }
+        break;
+      case '$':
+        {
+        const char* next = in + 1;
+        const char* start = NULL;
+        char nextc = *next;
+        if(nextc == '{')
+          {
+          start = in + 2;
+          token.Domain = NORMAL;
+          }
+        else if(nextc == '<')
+          {
+          }
+        else if(!nextc)
+          {
+          literal.append(last, next - last);
+          last = next;
+          }
+        else if(cmHasLiteralPrefix(next, "ENV{"))
+          {
+          start = in + 5;
+          token.Domain = ENVIRONMENT;
+          }
+        else if(cmHasLiteralPrefix(next, "CACHE{"))
+          {
+          start = in + 7;
+          token.Domain = CACHE;
+          }
+        else if(this->cmNamedCurly.find(next))
+          {
+          return false;
+          }
+        if(start)
+          {
+          literal.append(last, in - last);
+          if(!literal.empty())
+            {
+            token.Type = cmListFileArgumentTokens::Literal;
+            token.Text = literal;
+            tokens.Tokens.push_back(token);
+            literal = "";
+            }
+          token.Type = cmListFileArgumentTokens::Open;
+          token.Text = "";
+          tokens.Tokens.push_back(token);
+          ++depth;
+          last = start;
+          in = start - 1;
+          }
+        }
+        break;
+      case '\\':
+        {
+        const char* next = in + 1;
+        char nextc = *next;
+        if(nextc == 't')
+          {
+          literal.append(last, in - last);
+          literal.append("\t");
+          last = next + 1;
+          }
+        else if(nextc == 'n')
+          {
+          literal.append(last, in - last);
+          literal.append("\n");
+          last = next + 1;
+          }
+        else if(nextc == 'r')
+          {
+          literal.append(last, in - last);
+          literal.append("\r");
+          last = next + 1;
+          }
+        else if(nextc == ';' && depth == 0)
+          {
+          // Handled in ExpandListArgument; pass the backslash literally.
+          }
+        else if(isalnum(nextc) || nextc == '\0')
+          {
+          return false;
+          }
+        else
+          {
+          literal.append(last, in - last);
+          last = in + 1;
+          }
+        if(*last)
+          {
+          ++in;
+          }
+        }
+        break;
+      case '\n':
+        ++line;
+        break;
+      case '\0':
+        done = true;
+        break;
+      default:
+        if(depth > 0 &&
+           !(isalnum(inc) || inc == '_' ||
+             inc == '/' || inc == '.' ||
+             inc == '+' || inc == '-'))
+          {
+          return false;
+          }
+        break;
+      }
+    } while(!done && *++in);
+
+  if(depth != 0)
+    {
+    return false;
+    }
+  literal.append(last);
+  if(!literal.empty())
+    {
+    token.Type = cmListFileArgumentTokens::Literal;
+    token.Text = literal;
+    tokens.Tokens.push_back(token);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmMakefile::ExpandArgumentTokens(cmListFileArgumentTokens const& tokens,
+                                      const char* filename, long line,
+                                      std::string& result) const
+{
+  result = "";
+  std::vector<t_lookup> openstack;
+  for(std::vector<cmListFileArgumentTokens::Token>::const_iterator
+        ti = tokens.Tokens.begin(); ti != tokens.Tokens.end(); ++ti)
+    {
+    switch(ti->Type)
+      {
+      case cmListFileArgumentTokens::Literal:
+        result += ti->Text;
+        break;
+      case cmListFileArgumentTokens::Open:
+        {
+        t_lookup lookup;
+        lookup.domain = static_cast<t_domain>(ti->Domain);
+        lookup.loc = result.size();
+        openstack.push_back(lookup);
+        }
+        break;
+      case cmListFileArgumentTokens::Close:
+        {
+        t_lookup var = openstack.back();
+        openstack.pop_back();
+        std::string const& lookup = result.substr(var.loc);
+        std::string varresult;
+        this->ExpandVariableReference(varresult, var.domain, lookup,
+                                      false, filename, line + ti->Line,
+                                      false);
+        result.replace(var.loc, result.size() - var.loc, varresult);
+        }
+        break;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmMakefile::ExpandArgument(cmListFileArgument const& arg,
+                                std::string& value) const
+{
+  // Arguments are parsed into tokens once they are expanded a second
+  // time, as by loops and function bodies.  Only the new evaluation
+  // rules are supported.
+  if(arg.Delim != cmListFileArgument::Bracket)
+    {
+    cmPolicies::PolicyStatus status =
+      this->GetPolicyStatus(cmPolicies::CMP0053);
+    if(status != cmPolicies::OLD && status != cmPolicies::WARN)
+      {
+      if(!arg.Tokens && arg.Expanded)
+        {
+        // Count the expansion this object already had.
+        arg.ShareTokens();
+        arg.Tokens->Uses = 1;
+        }
+      arg.Expanded = true;
+      cmListFileArgumentTokens* tokens = arg.Tokens;
+      if(tokens && !tokens->Compiled && ++tokens->Uses > 1)
+        {
+        tokens->Compiled = true;
+        tokens->Valid = this->CompileArgumentTokens(arg.Value, *tokens);
+        if(!tokens->Valid)
+          {
+          tokens->Tokens.clear();
+          }
+        }
+      if(tokens && tokens->Valid)
+        {
+        this->ExpandArgumentTokens(*tokens, arg.FilePath, arg.Line, value);
+        return;
+        }
+      }
+    }
+  value = arg.Value;
+  this->ExpandVariablesInString(value, false, false, false,
+                                arg.FilePath, arg.Line,
+                                false, false);
+}
+
 void cmMakefile::RemoveVariablesInString(std::string& source,
                                          bool atOnly) const
 {
@@ -3329,10 +3768,7 @@ bool cmMakefile::ExpandArguments(
       continue;
       }
     // Expand the variables in the argument.
-    value = i->Value;
-    this->ExpandVariablesInString(value, false, false, false,
-                                  i->FilePath, i->Line,
-                                  false, false);
+    this->ExpandArgument(*i, value);
 
     // If the argument is quoted, it should be one argument.
     // Otherwise, it may be a list of arguments.
@@ -3365,10 +3801,7 @@ bool cmMakefile::ExpandArguments(
       continue;
       }
     // Expand the variables in the argument.
-    value = i->Value;
-    this->ExpandVariablesInString(value, false, false, false,
-                                  i->FilePath, i->Line,
-                                  false, false);
+    this->ExpandArgument(*i, value);
 
     // If the argument is quoted, it should be one argument.
     // Otherwise, it may be a list of arguments.
@@ -3499,17 +3932,70 @@ void cmMakefile::SetArgcArgv(const std::vector<std::string>& args)
   }
 }
 
+//----------------------------------------------------------------------------
+// Source names compare case-insensitively where paths do.
+static std::string cmMakefileSourceSearchKey(std::string const& name)
+{
+#if defined(_WIN32) || defined(__APPLE__)
+  return cmSystemTools::LowerCase(name);
+#else
+  return name;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void cmMakefile::IndexSourceFile(size_t index, std::string const& name) const
+{
+  // A source matches names that equal its own or that differ from it
+  // only by an extension when either extension is ambiguous.  Index it
+  // under its name and each prefix of the name ending before a dot, and
+  // look up the same set of keys for the name searched.
+  std::string key = cmMakefileSourceSearchKey(name);
+  for(std::string::size_type pos = key.size();
+      pos != std::string::npos && pos > 0; pos = key.rfind('.', pos - 1))
+    {
+    std::vector<size_t>& sources = this->SourceFileSearch[key.substr(0, pos)];
+    if(std::find(sources.begin(), sources.end(), index) == sources.end())
+      {
+      sources.push_back(index);
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 cmSourceFile* cmMakefile::GetSource(const std::string& sourceName) const
 {
   cmSourceFileLocation sfl(this, sourceName);
-  for(std::vector<cmSourceFile*>::const_iterator
-        sfi = this->SourceFiles.begin();
-      sfi != this->SourceFiles.end(); ++sfi)
+
+  // Collect the sources that may match in the order they were created.
+  std::vector<size_t> candidates;
+  std::string key = cmMakefileSourceSearchKey(sfl.GetName());
+  for(std::string::size_type pos = key.size();
+      pos != std::string::npos && pos > 0; pos = key.rfind('.', pos - 1))
     {
-    cmSourceFile* sf = *sfi;
+    SourceFileSearchIndex::const_iterator i =
+      this->SourceFileSearch.find(key.substr(0, pos));
+    if(i != this->SourceFileSearch.end())
+      {
+      candidates.insert(candidates.end(), i->second.begin(), i->second.end());
+      }
+    }
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                   candidates.end());
+
+  for(std::vector<size_t>::const_iterator ci = candidates.begin();
+      ci != candidates.end(); ++ci)
+    {
+    cmSourceFile* sf = this->SourceFiles[*ci];
+    std::string name = sf->GetLocation().GetName();
     if(sf->Matches(sfl))
       {
+      // A match may resolve an ambiguous extension.
+      if(sf->GetLocation().GetName() != name)
+        {
+        this->IndexSourceFile(*ci, sf->GetLocation().GetName());
+        }
       return sf;
       }
     }
@@ -3526,6 +4012,8 @@ cmSourceFile* cmMakefile::CreateSource(const std::string& sourceName,
     sf->SetProperty("GENERATED", "1");
     }
   this->SourceFiles.push_back(sf);
+  this->IndexSourceFile(this->SourceFiles.size() - 1,
+                        sf->GetLocation().GetName());
   return sf;
 }
 
@@ -4386,11 +4874,11 @@ std::string cmMakefile::GetListFileStack() const
 void cmMakefile::PushScope()
 {
   cmDefinitions* parent = &this->Internal->VarStack.top();
-  const std::set<std::string>& init = this->Internal->VarInitStack.top();
-  const std::set<std::string>& usage = this->Internal->VarUsageStack.top();
   this->Internal->VarStack.push(cmDefinitions(parent));
-  this->Internal->VarInitStack.push(init);
-  this->Internal->VarUsageStack.push(usage);
+  if (cmMakefileVariableUsage* usage = this->Internal->VarUsage.get())
+    {
+    usage->PushScope();
+    }
 
   this->PushLoopBlockBarrier();
 
@@ -4409,31 +4897,28 @@ void cmMakefile::PopScope()
 
   this->PopLoopBlockBarrier();
 
-  cmDefinitions* current = &this->Internal->VarStack.top();
-  std::set<std::string> init = this->Internal->VarInitStack.top();
-  std::set<std::string> usage = this->Internal->VarUsageStack.top();
-  const std::set<std::string>& locals = current->LocalKeys();
-  // Remove initialization and usage information for variables in the local
-  // scope.
-  std::set<std::string>::const_iterator it = locals.begin();
-  for (; it != locals.end(); ++it)
+  if (cmMakefileVariableUsage* usage = this->Internal->VarUsage.get())
     {
-    init.erase(*it);
-    if (!this->VariableUsed(*it))
+    // Remove initialization and usage information for variables in the
+    // local scope.
+    cmDefinitions* current = &this->Internal->VarStack.top();
+    const std::set<std::string>& locals = current->LocalKeys();
+    std::set<std::string> usedLocals;
+    std::set<std::string>::const_iterator it = locals.begin();
+    for (; it != locals.end(); ++it)
       {
-      this->CheckForUnused("out of scope", *it);
-      }
-    else
-      {
-      usage.erase(*it);
+      if (!this->VariableUsed(*it))
+        {
+        this->CheckForUnused("out of scope", *it);
+        }
+      else
+        {
+        usedLocals.insert(*it);
+        }
       }
+    usage->PopScope(locals, usedLocals);
     }
   this->Internal->VarStack.pop();
-  this->Internal->VarInitStack.pop();
-  this->Internal->VarUsageStack.pop();
-  // Push initialization and usage up to the parent scope.
-  this->Internal->VarInitStack.top().insert(init.begin(), init.end());
-  this->Internal->VarUsageStack.top().insert(usage.begin(), usage.end());
 }
 
 void cmMakefile::RaiseScope(const std::string& var, const char *varDef)
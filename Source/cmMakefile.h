@@ -1091,6 +1091,8 @@ private:
   {
     cmListFileContext const* Context;
     cmExecutionStatus* Status;
+    // The backtrace ending in this entry, created when first requested.
+    mutable cmListFileBacktrace Backtrace;
   };
   typedef std::deque<CallStackEntry> CallStackType;
   CallStackType CallStack;
@@ -1151,6 +1153,18 @@ private:
                                   long line,
                                   bool removeEmpty,
                                   bool replaceAt) const;
+  void ExpandVariableReference(std::string& varresult, int domain,
+                               std::string const& lookup,
+                               bool escapeQuotes, const char* filename,
+                               long line, bool removeEmpty) const;
+  // CMP0053 == new, for list file arguments expanded repeatedly
+  void ExpandArgument(cmListFileArgument const& arg,
+                      std::string& value) const;
+  bool CompileArgumentTokens(std::string const& source,
+                             cmListFileArgumentTokens& tokens) const;
+  void ExpandArgumentTokens(cmListFileArgumentTokens const& tokens,
+                            const char* filename, long line,
+                            std::string& result) const;
   bool GeneratingBuildSystem;
   /**
    * Old version of GetSourceFileWithOutput(const std::string&) kept for
@@ -1168,6 +1182,17 @@ private:
 #endif
   OutputToSourceMap OutputToSource;
 
+  // An index of SourceFiles by the names under which GetSource may find
+  // each entry.
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  typedef cmsys::hash_map<std::string, std::vector<size_t> >
+    SourceFileSearchIndex;
+#else
+  typedef std::map<std::string, std::vector<size_t> > SourceFileSearchIndex;
+#endif
+  mutable SourceFileSearchIndex SourceFileSearch;
+  void IndexSourceFile(size_t index, std::string const& name) const;
+
   void UpdateOutputToSourceMap(std::vector<std::string> const& outputs,
                                cmSourceFile* source);
   void UpdateOutputToSourceMap(std::string const& output,
@@ -1203,7 +1228,7 @@ public:
                  cmListFileContext const& lfc,
                  cmExecutionStatus& status): Makefile(mf)
     {
-    cmMakefile::CallStackEntry entry = {&lfc, &status};
+    cmMakefile::CallStackEntry entry = {&lfc, &status, 0};
     this->Makefile->CallStack.push_back(entry);
     }
   ~cmMakefileCall()
@@ -0,0 +1,123 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmMakefileProfilingData.h"
+
+#include "cmListFileCache.h"
+#include "cmSystemTools.h"
+
+//----------------------------------------------------------------------------
+static void cmMakefileProfilingDataWriteString(std::ostream& os,
+                                               std::string const& s)
+{
+  os << '"';
+  for(std::string::const_iterator c = s.begin(); c != s.end(); ++c)
+    {
+    switch(*c)
+      {
+      case '"': os << "\\\""; break;
+      case '\\': os << "\\\\"; break;
+      case '\n': os << "\\n"; break;
+      case '\r': os << "\\r"; break;
+      case '\t': os << "\\t"; break;
+      default:
+        if(static_cast<unsigned char>(*c) < 0x20)
+          {
+          char buf[8];
+          sprintf(buf, "\\u%04x", static_cast<unsigned int>(*c));
+          os << buf;
+          }
+        else
+          {
+          os << *c;
+          }
+        break;
+      }
+    }
+  os << '"';
+}
+
+//----------------------------------------------------------------------------
+cmMakefileProfilingData::cmMakefileProfilingData(std::string const& path):
+  Stream(path.c_str()), StartTime(cmSystemTools::GetTime()), First(true)
+{
+  this->Valid = this->Stream ? true : false;
+  if(this->Valid)
+    {
+    this->Stream << "[";
+    }
+}
+
+//----------------------------------------------------------------------------
+cmMakefileProfilingData::~cmMakefileProfilingData()
+{
+  if(this->Valid)
+    {
+    this->Stream << "\n]\n";
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmMakefileProfilingData::WriteTime()
+{
+  // Timestamps are in microseconds since profiling started.
+  char buf[64];
+  sprintf(buf, "%.0f",
+          (cmSystemTools::GetTime() - this->StartTime) * 1000000.0);
+  this->Stream << ",\"ts\":" << buf;
+}
+
+//----------------------------------------------------------------------------
+void cmMakefileProfilingData::StartEntry(cmListFileFunction const& lff)
+{
+  if(!this->Valid)
+    {
+    return;
+    }
+  this->Stream << (this->First? "\n" : ",\n");
+  this->First = false;
+
+  this->Stream << "{\"name\":";
+  cmMakefileProfilingDataWriteString(this->Stream,
+                                     cmSystemTools::LowerCase(lff.Name));
+  this->Stream << ",\"cat\":\"cmake\",\"ph\":\"B\",\"pid\":0,\"tid\":0";
+  this->WriteTime();
+
+  std::ostringstream location;
+  location << lff.FilePath << ":" << lff.Line;
+  std::string args;
+  for(std::vector<cmListFileArgument>::const_iterator
+        a = lff.Arguments.begin(); a != lff.Arguments.end(); ++a)
+    {
+    if(a != lff.Arguments.begin())
+      {
+      args += " ";
+      }
+    args += a->Value;
+    }
+  this->Stream << ",\"args\":{\"location\":";
+  cmMakefileProfilingDataWriteString(this->Stream, location.str());
+  this->Stream << ",\"functionArgs\":";
+  cmMakefileProfilingDataWriteString(this->Stream, args);
+  this->Stream << "}}";
+}
+
+//----------------------------------------------------------------------------
+void cmMakefileProfilingData::StopEntry()
+{
+  if(!this->Valid)
+    {
+    return;
+    }
+  this->Stream << ",\n{\"ph\":\"E\",\"pid\":0,\"tid\":0";
+  this->WriteTime();
+  this->Stream << "}";
+}
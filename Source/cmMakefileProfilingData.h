@@ -0,0 +1,76 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmMakefileProfilingData_h
+#define cmMakefileProfilingData_h
+
+#include "cmStandardIncludes.h"
+
+#include <cmsys/FStream.hxx>
+
+struct cmListFileFunction;
+
+/** \class cmMakefileProfilingData
+ * \brief Record the time spent executing list file commands.
+ *
+ * Each command invocation becomes a pair of begin and end events in a
+ * file using the Chrome trace event format, so nested invocations such
+ * as those in included files, functions and macros show up as nested
+ * spans.
+ */
+class cmMakefileProfilingData
+{
+public:
+  /** Open the output file.  Check IsValid() for success.  */
+  cmMakefileProfilingData(std::string const& path);
+
+  /** Finish the output file.  */
+  ~cmMakefileProfilingData();
+
+  bool IsValid() const { return this->Valid; }
+
+  void StartEntry(cmListFileFunction const& lff);
+  void StopEntry();
+
+  /** Record the execution of a command for the lifetime of the object
+      when given profiling data.  */
+  class Scope
+  {
+  public:
+    Scope(cmMakefileProfilingData* data, cmListFileFunction const& lff):
+      Data(data)
+      {
+      if(this->Data)
+        {
+        this->Data->StartEntry(lff);
+        }
+      }
+    ~Scope()
+      {
+      if(this->Data)
+        {
+        this->Data->StopEntry();
+        }
+      }
+  private:
+    cmMakefileProfilingData* Data;
+  };
+
+private:
+  void WriteTime();
+
+  cmsys::ofstream Stream;
+  double StartTime;
+  bool Valid;
+  bool First;
+};
+
+#endif
@@ -695,7 +695,26 @@ cmMakefileTargetGenerator
                                 cmLocalGenerator::START_OUTPUT,
                                 cmLocalGenerator::SHELL);
   vars.ObjectFileDir = objectFileDir.c_str();
-  vars.Flags = flags.c_str();
+
+  // Let the compiler write the dependencies of the object file next to
+  // it so that they need not be scanned.
+  std::string compileFlags = flags;
+  std::string depfileFlags =
+    this->LocalGenerator->GetCompilerDependsFlags(lang);
+  if(!depfileFlags.empty())
+    {
+    std::string depfile = obj + ".d";
+    this->CleanFiles.push_back(depfile);
+    depfile = this->Convert(depfile,
+                            cmLocalGenerator::NONE,
+                            cmLocalGenerator::SHELL);
+    cmSystemTools::ReplaceString(depfileFlags, "<DEPFILE>", depfile);
+    cmSystemTools::ReplaceString(depfileFlags, "<OBJECT>", shellObj);
+    cmSystemTools::ReplaceString(depfileFlags, "<CMAKE_C_COMPILER>",
+      this->Makefile->GetSafeDefinition("CMAKE_C_COMPILER"));
+    this->LocalGenerator->AppendFlags(compileFlags, depfileFlags);
+    }
+  vars.Flags = compileFlags.c_str();
 
   std::string definesString = "$(";
   definesString += lang;
@@ -778,6 +797,7 @@ cmMakefileTargetGenerator
     this->LocalGenerator->GetCreateAssemblySourceRules();
   if(do_preprocess_rules || do_assembly_rules)
     {
+    vars.Flags = flags.c_str();
     std::vector<std::string> force_depends;
     force_depends.push_back("cmake_force");
     std::string::size_type dot_pos = relativeObj.rfind(".");
@@ -1081,6 +1101,15 @@ void cmMakefileTargetGenerator::WriteTargetDependRules()
     *this->InfoFileStream << "  )\n\n";
     }
 
+  // Scans skipped by the batch check may miss regenerated dependees.
+  if(this->LocalGenerator->GetBatchDepends())
+    {
+    *this->InfoFileStream
+      << "\n"
+      << "# Dependencies of all targets are checked at once.\n"
+      << "set(CMAKE_DEPENDS_BATCH 1)\n";
+    }
+
   // Store list of targets linked directly or transitively.
   {
   *this->InfoFileStream
@@ -1151,6 +1180,20 @@ void cmMakefileTargetGenerator::WriteTargetDependRules()
                cmLocalGenerator::FULL, cmLocalGenerator::SHELL))
          << " && ";
 #endif
+  // When the build system checks the dependencies of all targets at
+  // once it leaves a depend.valid file for each target that needs no
+  // scanning.  The multiple output pairs are checked only here.
+  std::string validFile = this->TargetBuildDirectoryFull;
+  validFile += "/depend.valid";
+  cmSystemTools::RemoveFile(validFile);
+  if(this->LocalGenerator->GetBatchDepends() &&
+     this->MultipleOutputPairs.empty())
+    {
+    depCmd << "test -f "
+           << this->Convert(validFile,
+                            cmLocalGenerator::FULL, cmLocalGenerator::SHELL)
+           << " || ";
+    }
   // Generate a call this signature:
   //
   //   cmake -E cmake_depends <generator>
@@ -50,6 +50,8 @@ public:
   */
   virtual bool IsScriptable() const { return true; }
 
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmMarkAsAdvancedCommand, cmCommand);
 };
 
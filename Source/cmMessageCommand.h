@@ -46,6 +46,8 @@ public:
    */
   virtual bool IsScriptable() const { return true; }
 
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmMessageCommand, cmCommand);
 };
 
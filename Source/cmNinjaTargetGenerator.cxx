@@ -76,9 +76,15 @@ cmNinjaTargetGenerator::~cmNinjaTargetGenerator()
   delete this->MacOSXContentGenerator;
 }
 
-cmGeneratedFileStream& cmNinjaTargetGenerator::GetBuildFileStream() const
+std::ostream& cmNinjaTargetGenerator::GetBuildFileStream() const
 {
-  return *this->GetGlobalGenerator()->GetBuildFileStream();
+  return this->BuildFileBuffer;
+}
+
+void cmNinjaTargetGenerator::WriteBuildStatements(std::ostream& os) const
+{
+  std::string const& statements = this->BuildFileBuffer.str();
+  os.write(statements.data(), static_cast<std::streamsize>(statements.size()));
 }
 
 cmGeneratedFileStream& cmNinjaTargetGenerator::GetRulesFileStream() const
@@ -40,6 +40,10 @@ public:
 
   virtual void Generate() = 0;
 
+  /** Write the build statements generated for the target to the given
+      stream.  They are collected in memory by Generate().  */
+  void WriteBuildStatements(std::ostream& os) const;
+
   std::string GetTargetName() const;
 
   bool NeedDepTypeMSVC(const std::string& lang) const;
@@ -48,7 +52,7 @@ protected:
 
   bool SetMsvcTargetPdbVariable(cmNinjaVars&) const;
 
-  cmGeneratedFileStream& GetBuildFileStream() const;
+  std::ostream& GetBuildFileStream() const;
   cmGeneratedFileStream& GetRulesFileStream() const;
 
   cmTarget* GetTarget() const
@@ -164,6 +168,9 @@ private:
 
   // The windows module definition source file (.def), if any.
   std::string ModuleDefinitionFile;
+
+  /// The build statements of this target, written by the local generator.
+  mutable std::ostringstream BuildFileBuffer;
 };
 
 #endif // ! cmNinjaTargetGenerator_h
@@ -47,6 +47,8 @@ public:
    */
   virtual bool IsScriptable() const { return true; }
 
+  virtual bool IsStateless() const { return true; }
+
   cmTypeMacro(cmOptionCommand, cmCommand);
 };
 
@@ -21,11 +21,10 @@ public:
                    TEST, VARIABLE, CACHED_VARIABLE, INSTALL };
 
   // set this property
-  void Set(const std::string& name, const char *value);
+  void Set(const char *value);
 
   // append to this property
-  void Append(const std::string& name, const char *value,
-              bool asString = false);
+  void Append(const char *value, bool asString = false);
 
   // get the value
   const char *GetValue() const;
@@ -34,7 +33,6 @@ public:
   cmProperty() { this->ValueHasBeenSet = false; }
 
 protected:
-  std::string Name;
   std::string Value;
   bool ValueHasBeenSet;
 };
@@ -13,19 +13,142 @@
 #include "cmSystemTools.h"
 #include "cmake.h"
 
-cmProperty *cmPropertyMap::GetOrCreateProperty(const std::string& name)
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+# include <cmsys/hash_map.hxx>
+#endif
+
+#include <algorithm>
+
+namespace
 {
-  cmPropertyMap::iterator it = this->find(name);
-  cmProperty *prop;
-  if (it == this->end())
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+typedef cmsys::hash_map<std::string, unsigned int> cmPropertyMapIdTable;
+#else
+typedef std::map<std::string, unsigned int> cmPropertyMapIdTable;
+#endif
+
+// The table of interned property names, shared by all maps.
+cmPropertyMapIdTable& cmPropertyMapIds()
+{
+  static cmPropertyMapIdTable ids;
+  return ids;
+}
+
+// Get the id of a name stored in some map, or return false if no map has
+// ever stored it.
+bool cmPropertyMapFindId(const std::string& name, unsigned int& id)
+{
+  cmPropertyMapIdTable const& ids = cmPropertyMapIds();
+  cmPropertyMapIdTable::const_iterator i = ids.find(name);
+  if(i == ids.end())
     {
-    prop = &(*this)[name];
+    return false;
     }
-  else
+  id = i->second;
+  return true;
+}
+
+// Get the id of a name, interning it if necessary.
+unsigned int cmPropertyMapInternId(const std::string& name)
+{
+  cmPropertyMapIdTable& ids = cmPropertyMapIds();
+  cmPropertyMapIdTable::iterator i = ids.find(name);
+  if(i == ids.end())
+    {
+    unsigned int id = static_cast<unsigned int>(ids.size());
+    i = ids.insert(cmPropertyMapIdTable::value_type(name, id)).first;
+    }
+  return i->second;
+}
+}
+
+bool cmPropertyMap::EntryLess(Entry const& l, Entry const& r)
+{
+  return l.Id < r.Id;
+}
+
+cmPropertyMap::EntriesType::iterator cmPropertyMap::Find(unsigned int id)
+{
+  Entry key = { id, 0 };
+  return std::lower_bound(this->Entries.begin(), this->Entries.end(), key,
+                          EntryLess);
+}
+
+size_t cmPropertyMap::FindIndex(const std::string& name) const
+{
+  unsigned int id;
+  if(cmPropertyMapFindId(name, id))
     {
-    prop = &(it->second);
+    Entry key = { id, 0 };
+    EntriesType::const_iterator i =
+      std::lower_bound(this->Entries.begin(), this->Entries.end(), key,
+                       EntryLess);
+    if(i != this->Entries.end() && i->Id == id)
+      {
+      return i - this->Entries.begin();
+      }
     }
-  return prop;
+  return this->Entries.size();
+}
+
+cmPropertyMap::cmPropertyMap(cmPropertyMap const& r):
+  Entries(r.Entries), CMakeInstance(r.CMakeInstance)
+{
+  // Copy the entries themselves.
+  for(EntriesType::iterator i = this->Entries.begin();
+      i != this->Entries.end(); ++i)
+    {
+    i->Value = new value_type(*i->Value);
+    }
+}
+
+cmPropertyMap& cmPropertyMap::operator=(cmPropertyMap const& r)
+{
+  if(this != &r)
+    {
+    cmPropertyMap copy(r);
+    this->Entries.swap(copy.Entries);
+    this->CMakeInstance = copy.CMakeInstance;
+    }
+  return *this;
+}
+
+cmPropertyMap::~cmPropertyMap()
+{
+  this->clear();
+}
+
+cmPropertyMap::iterator cmPropertyMap::find(const std::string& name)
+{
+  return this->Entries.begin() + this->FindIndex(name);
+}
+
+cmPropertyMap::const_iterator
+cmPropertyMap::find(const std::string& name) const
+{
+  return this->Entries.begin() + this->FindIndex(name);
+}
+
+void cmPropertyMap::clear()
+{
+  for(EntriesType::iterator i = this->Entries.begin();
+      i != this->Entries.end(); ++i)
+    {
+    delete i->Value;
+    }
+  this->Entries.clear();
+}
+
+cmProperty *cmPropertyMap::GetOrCreateProperty(const std::string& name)
+{
+  unsigned int id = cmPropertyMapInternId(name);
+  EntriesType::iterator i = this->Find(id);
+  if(i == this->Entries.end() || i->Id != id)
+    {
+    Entry e = { id, new value_type(name, cmProperty()) };
+    i = this->Entries.insert(i, e);
+    }
+  return &i->Value->second;
 }
 
 void cmPropertyMap::SetProperty(const std::string& name, const char *value,
@@ -33,13 +156,18 @@ void cmPropertyMap::SetProperty(const std::string& name, const char *value,
 {
   if(!value)
     {
-    this->erase(name);
+    size_t index = this->FindIndex(name);
+    if(index != this->Entries.size())
+      {
+      delete this->Entries[index].Value;
+      this->Entries.erase(this->Entries.begin() + index);
+      }
     return;
     }
   (void)scope;
 
   cmProperty *prop = this->GetOrCreateProperty(name);
-  prop->Set(name,value);
+  prop->Set(value);
 }
 
 void cmPropertyMap::AppendProperty(const std::string& name, const char* value,
@@ -53,7 +181,7 @@ void cmPropertyMap::AppendProperty(const std::string& name, const char* value,
   (void)scope;
 
   cmProperty *prop = this->GetOrCreateProperty(name);
-  prop->Append(name,value,asString);
+  prop->Append(value,asString);
 }
 
 const char *cmPropertyMap
@@ -79,4 +207,3 @@ const char *cmPropertyMap
     }
   return it->second.GetValue();
 }
-
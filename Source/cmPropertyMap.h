@@ -16,9 +16,59 @@
 
 class cmake;
 
-class cmPropertyMap : public std::map<std::string,cmProperty>
+/** \class cmPropertyMap
+ * \brief Store the properties of a target, source file, directory, etc.
+ *
+ * Property names are interned in a table shared by all maps.  Each map
+ * keeps a vector of pointers to its entries sorted by the interned id of
+ * their names, so a lookup hashes the name once and then searches the
+ * ids.  Looking up a name that no map has ever stored needs only the
+ * table lookup.  Entries are allocated separately, so pointers to them
+ * and to their values remain valid until they are removed.  Iteration
+ * visits the entries in the order their names were first interned.
+ */
+class cmPropertyMap
 {
+  struct Entry
+  {
+    unsigned int Id;
+    std::pair<const std::string, cmProperty>* Value;
+  };
+  typedef std::vector<Entry> EntriesType;
 public:
+  typedef std::pair<const std::string, cmProperty> value_type;
+
+  template <typename V, typename I>
+  class Iterator
+  {
+  public:
+    Iterator() {}
+    Iterator(I i): It(i) {}
+    template <typename V2, typename I2>
+    Iterator(Iterator<V2, I2> const& r): It(r.It) {}
+    V& operator*() const { return *this->It->Value; }
+    V* operator->() const { return this->It->Value; }
+    Iterator& operator++() { ++this->It; return *this; }
+    Iterator operator++(int) { Iterator r = *this; ++this->It; return r; }
+    bool operator==(Iterator const& r) const { return this->It == r.It; }
+    bool operator!=(Iterator const& r) const { return this->It != r.It; }
+    I It;
+  };
+  typedef Iterator<value_type, EntriesType::iterator> iterator;
+  typedef Iterator<value_type const, EntriesType::const_iterator>
+    const_iterator;
+
+  iterator begin() { return this->Entries.begin(); }
+  iterator end() { return this->Entries.end(); }
+  const_iterator begin() const { return this->Entries.begin(); }
+  const_iterator end() const { return this->Entries.end(); }
+  bool empty() const { return this->Entries.empty(); }
+  size_t size() const { return this->Entries.size(); }
+  void clear();
+
+  iterator find(const std::string& name);
+  const_iterator find(const std::string& name) const;
+
   cmProperty *GetOrCreateProperty(const std::string& name);
 
   void SetProperty(const std::string& name, const char *value,
@@ -34,10 +84,17 @@ public:
   void SetCMakeInstance(cmake *cm) { this->CMakeInstance = cm; }
 
   cmPropertyMap() { this->CMakeInstance = 0;}
+  cmPropertyMap(cmPropertyMap const& r);
+  cmPropertyMap& operator=(cmPropertyMap const& r);
+  ~cmPropertyMap();
 
 private:
+  static bool EntryLess(Entry const& l, Entry const& r);
+  EntriesType::iterator Find(unsigned int id);
+  size_t FindIndex(const std::string& name) const;
+
+  EntriesType Entries;
   cmake *CMakeInstance;
 };
 
 #endif
-
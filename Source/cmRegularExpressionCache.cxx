@@ -0,0 +1,87 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmRegularExpressionCache.h"
+
+#include <list>
+
+// The number of compiled patterns kept.
+#define CM_REGULAR_EXPRESSION_CACHE_SIZE 256
+
+struct cmRegularExpressionCacheEntry
+{
+  std::string Pattern;
+  cmsys::RegularExpression Regex;
+};
+
+struct cmRegularExpressionCacheState
+{
+  cmRegularExpressionCacheState(): Hits(0), Misses(0) {}
+  typedef std::list<cmRegularExpressionCacheEntry> EntryList;
+  // Most recently used first.
+  EntryList Entries;
+  std::map<std::string, EntryList::iterator> Index;
+  unsigned long Hits;
+  unsigned long Misses;
+};
+
+//----------------------------------------------------------------------------
+static cmRegularExpressionCacheState& cmRegularExpressionCacheGetState()
+{
+  static cmRegularExpressionCacheState state;
+  return state;
+}
+
+//----------------------------------------------------------------------------
+bool cmRegularExpressionCache::Compile(cmsys::RegularExpression& re,
+                                       std::string const& pattern)
+{
+  cmRegularExpressionCacheState& state = cmRegularExpressionCacheGetState();
+  std::map<std::string, cmRegularExpressionCacheState::EntryList::iterator>
+    ::iterator i = state.Index.find(pattern);
+  if(i != state.Index.end())
+    {
+    ++state.Hits;
+    state.Entries.splice(state.Entries.begin(), state.Entries, i->second);
+    re = i->second->Regex;
+    return true;
+    }
+
+  ++state.Misses;
+  if(!re.compile(pattern.c_str()))
+    {
+    return false;
+    }
+
+  // Only valid patterns are cached so that errors are reported each time.
+  if(state.Index.size() >= CM_REGULAR_EXPRESSION_CACHE_SIZE)
+    {
+    state.Index.erase(state.Entries.back().Pattern);
+    state.Entries.pop_back();
+    }
+  state.Entries.push_front(cmRegularExpressionCacheEntry());
+  state.Entries.front().Pattern = pattern;
+  state.Entries.front().Regex = re;
+  state.Index[pattern] = state.Entries.begin();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+unsigned long cmRegularExpressionCache::GetHits()
+{
+  return cmRegularExpressionCacheGetState().Hits;
+}
+
+//----------------------------------------------------------------------------
+unsigned long cmRegularExpressionCache::GetMisses()
+{
+  return cmRegularExpressionCacheGetState().Misses;
+}
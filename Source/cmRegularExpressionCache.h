@@ -0,0 +1,39 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmRegularExpressionCache_h
+#define cmRegularExpressionCache_h
+
+#include "cmStandardIncludes.h"
+
+#include <cmsys/RegularExpression.hxx>
+
+/** \class cmRegularExpressionCache
+ * \brief Process-wide cache of compiled regular expressions.
+ *
+ * Commands that match the same patterns over and over copy the compiled
+ * program of a recently used pattern instead of compiling it again.  The
+ * least recently used pattern is dropped when the cache is full.
+ */
+class cmRegularExpressionCache
+{
+public:
+  /** Make the given expression hold the compiled form of the pattern.
+      Returns false if the pattern does not compile.  */
+  static bool Compile(cmsys::RegularExpression& re,
+                      std::string const& pattern);
+
+  /** Number of patterns found in and missing from the cache.  */
+  static unsigned long GetHits();
+  static unsigned long GetMisses();
+};
+
+#endif
@@ -11,6 +11,7 @@
 ============================================================================*/
 #include "cmStringCommand.h"
 #include "cmCryptoHash.h"
+#include "cmRegularExpressionCache.h"
 
 #include <cmsys/RegularExpression.hxx>
 #include <cmsys/SystemTools.hxx>
@@ -306,7 +307,7 @@ bool cmStringCommand::RegexMatch(std::vector<std::string> const& args)
   this->Makefile->ClearMatches();
   // Compile the regular expression.
   cmsys::RegularExpression re;
-  if(!re.compile(regex.c_str()))
+  if(!cmRegularExpressionCache::Compile(re, regex))
     {
     std::string e =
       "sub-command REGEX, mode MATCH failed to compile regex \""+regex+"\".";
@@ -351,7 +352,7 @@ bool cmStringCommand::RegexMatchAll(std::vector<std::string> const& args)
   this->Makefile->ClearMatches();
   // Compile the regular expression.
   cmsys::RegularExpression re;
-  if(!re.compile(regex.c_str()))
+  if(!cmRegularExpressionCache::Compile(re, regex))
     {
     std::string e =
       "sub-command REGEX, mode MATCHALL failed to compile regex \""+
@@ -451,7 +452,7 @@ bool cmStringCommand::RegexReplace(std::vector<std::string> const& args)
   this->Makefile->ClearMatches();
   // Compile the regular expression.
   cmsys::RegularExpression re;
-  if(!re.compile(regex.c_str()))
+  if(!cmRegularExpressionCache::Compile(re, regex))
     {
     std::string e =
       "sub-command REGEX, mode REPLACE failed to compile regex \""+
@@ -114,12 +114,10 @@ public:
   {
     OptionalLinkInterface():
       LibrariesDone(false), AllDone(false),
-      Exists(false), HadHeadSensitiveCondition(false),
-      ExplicitLibraries(0) {}
+      Exists(false), ExplicitLibraries(0) {}
     bool LibrariesDone;
     bool AllDone;
     bool Exists;
-    bool HadHeadSensitiveCondition;
     const char* ExplicitLibraries;
   };
   void ComputeLinkInterface(cmTarget const* thisTarget,
@@ -202,11 +200,15 @@ public:
     static cmLinkImplItem NoLinkImplItem;
   public:
     TargetPropertyEntry(cmsys::auto_ptr<cmCompiledGeneratorExpression> cge,
-                        cmLinkImplItem const& item = NoLinkImplItem)
-      : ge(cge), LinkImplItem(item)
+                        cmLinkImplItem const& item = NoLinkImplItem,
+                        std::string const& interfaceProperty = "")
+      : ge(cge), LinkImplItem(item), InterfaceProperty(interfaceProperty)
     {}
     const cmsys::auto_ptr<cmCompiledGeneratorExpression> ge;
     cmLinkImplItem const& LinkImplItem;
+    // The INTERFACE_ property of LinkImplItem read by an entry added
+    // from the link implementation.
+    const std::string InterfaceProperty;
   };
   std::vector<TargetPropertyEntry*> IncludeDirectoriesEntries;
   std::vector<TargetPropertyEntry*> CompileOptionsEntries;
@@ -218,6 +220,50 @@ public:
   void AddInterfaceEntries(
     cmTarget const* thisTarget, std::string const& config,
     std::string const& prop, std::vector<TargetPropertyEntry*>& entries);
+
+  // Cache usage requirements computed for each configuration and language.
+  // Entries are stored only once the build system is being generated and
+  // the properties of all targets are final.
+  struct UsageRequirementsCache:
+    public std::map<std::pair<std::string, std::string>,
+                    std::vector<std::string> >
+  {
+    bool Lookup(std::string const& config, std::string const& language,
+                std::vector<std::string>& result) const;
+    void Store(cmMakefile const* mf,
+               std::string const& config, std::string const& language,
+               std::vector<std::string> const& result, size_t start);
+  };
+  UsageRequirementsCache IncludeDirectoriesCache;
+  UsageRequirementsCache CompileOptionsCache;
+  UsageRequirementsCache CompileFeaturesCache;
+  UsageRequirementsCache CompileDefinitionsCache;
+
+  // Cache the transitive closure of each INTERFACE_ usage requirement of
+  // this target as evaluated for consumers in a given directory.  Only
+  // values that do not depend on the consuming target are stored, so that
+  // the dependencies of a widely used target are walked once.
+  struct InterfaceClosureKey
+  {
+    InterfaceClosureKey(std::string const& prop, std::string const& config,
+                        std::string const& language, cmMakefile const* mf):
+      Property(prop), Config(config), Language(language), Makefile(mf) {}
+    std::string Property;
+    std::string Config;
+    std::string Language;
+    cmMakefile const* Makefile;
+    bool operator<(InterfaceClosureKey const& r) const;
+  };
+  typedef std::map<InterfaceClosureKey, std::string> InterfaceClosureMapType;
+  InterfaceClosureMapType InterfaceClosureMap;
+
+  static std::string EvaluateEntry(cmTarget const* tgt,
+                                   TargetPropertyEntry const& entry,
+                                   cmGeneratorExpressionDAGChecker* dagChecker,
+                                   std::string const& config,
+                                   std::string const& language);
+
+  void ClearUsageRequirementsCaches();
 };
 
 cmLinkImplItem cmTargetInternals::TargetPropertyEntry::NoLinkImplItem;
@@ -235,6 +281,118 @@ cmTargetInternals::~cmTargetInternals()
 {
 }
 
+//----------------------------------------------------------------------------
+bool cmTargetInternals::UsageRequirementsCache
+::Lookup(std::string const& config, std::string const& language,
+         std::vector<std::string>& result) const
+{
+  const_iterator i = this->find(std::make_pair(config, language));
+  if(i == this->end())
+    {
+    return false;
+    }
+  result.insert(result.end(), i->second.begin(), i->second.end());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmTargetInternals::UsageRequirementsCache
+::Store(cmMakefile const* mf,
+        std::string const& config, std::string const& language,
+        std::vector<std::string> const& result, size_t start)
+{
+  // A target's own entries are cleared when they change, but nothing
+  // clears the entries of its consumers when its INTERFACE_ properties
+  // change.  That is unnecessary only because no property of any target
+  // changes once the build system is being generated, so store nothing
+  // before that.
+  if(!mf->IsGeneratingBuildSystem())
+    {
+    return;
+    }
+  std::vector<std::string>& entry =
+    (*this)[std::make_pair(config, language)];
+  entry.assign(result.begin() + start, result.end());
+}
+
+//----------------------------------------------------------------------------
+void cmTargetInternals::ClearUsageRequirementsCaches()
+{
+  this->IncludeDirectoriesCache.clear();
+  this->CompileOptionsCache.clear();
+  this->CompileFeaturesCache.clear();
+  this->CompileDefinitionsCache.clear();
+  this->InterfaceClosureMap.clear();
+}
+
+//----------------------------------------------------------------------------
+bool cmTargetInternals::InterfaceClosureKey
+::operator<(InterfaceClosureKey const& r) const
+{
+  if(this->Makefile != r.Makefile)
+    {
+    return this->Makefile < r.Makefile;
+    }
+  if(this->Property != r.Property)
+    {
+    return this->Property < r.Property;
+    }
+  if(this->Config != r.Config)
+    {
+    return this->Config < r.Config;
+    }
+  return this->Language < r.Language;
+}
+
+//----------------------------------------------------------------------------
+std::string
+cmTargetInternals::EvaluateEntry(cmTarget const* tgt,
+                                 TargetPropertyEntry const& entry,
+                                 cmGeneratorExpressionDAGChecker* dagChecker,
+                                 std::string const& config,
+                                 std::string const& language)
+{
+  cmMakefile* mf = tgt->GetMakefile();
+  cmTarget const* dependency = entry.LinkImplItem.Target;
+  if(!dependency || entry.InterfaceProperty.empty()
+     || !mf->IsGeneratingBuildSystem())
+    {
+    return entry.ge->Evaluate(mf, config, false, tgt, dagChecker, language);
+    }
+
+  InterfaceClosureKey key(entry.InterfaceProperty, config, language, mf);
+  InterfaceClosureMapType& closures =
+    dependency->Internal->InterfaceClosureMap;
+  InterfaceClosureMapType::const_iterator i = closures.find(key);
+  if(i != closures.end())
+    {
+    return i->second;
+    }
+
+  // Evaluate the closure quietly beneath a checker that does not name
+  // the consumer.  The consumer's checker skips dependencies already seen
+  // through earlier entries, but callers drop duplicate values anyway.
+  std::string const property = entry.InterfaceProperty.substr(
+    sizeof("INTERFACE_") - 1);
+  cmGeneratorExpressionDAGChecker closureChecker("", property, 0, 0);
+  std::string result = entry.ge->Evaluate(mf, config, true, tgt,
+                                          &closureChecker, language);
+  if(entry.ge->GetHadError() || closureChecker.SawPropertyOnTarget(property))
+    {
+    // Either the closure is in error, or it reads the non-interface
+    // property of some target, so its value depends on whether that
+    // target is the consumer, which would be a cyclic reference.
+    // Evaluate it exactly for this consumer, which reports any errors.
+    return entry.ge->Evaluate(mf, config, false, tgt, dagChecker, language);
+    }
+  if(entry.ge->GetHadHeadSensitiveCondition())
+    {
+    return result;
+    }
+  closures.insert(InterfaceClosureMapType::value_type(key, result));
+  return result;
+}
+
 //----------------------------------------------------------------------------
 cmTarget::cmTarget()
 {
@@ -315,6 +473,24 @@ void cmTarget::SetMakefile(cmMakefile* mf)
   // Check whether we are targeting an Apple platform.
   this->IsApple = this->Makefile->IsOn("APPLE");
 
+  // Record current policies for later use.
+#define CAPTURE_TARGET_POLICY(POLICY) \
+  this->PolicyStatus ## POLICY = \
+    this->Makefile->GetPolicyStatus(cmPolicies::POLICY);
+
+  CM_FOR_EACH_TARGET_POLICY(CAPTURE_TARGET_POLICY)
+
+#undef CAPTURE_TARGET_POLICY
+
+  // The generator places a copy of each global target, such as "install"
+  // or "test", in every directory.  They only run a command, so skip the
+  // property defaults and usage requirements of the directory.
+  if (this->GetType() == GLOBAL_TARGET)
+    {
+    this->Internal->Backtrace = this->Makefile->GetBacktrace();
+    return;
+    }
+
   // Setup default property values.
   if (this->GetType() != INTERFACE_LIBRARY && this->GetType() != UTILITY)
     {
@@ -452,15 +628,6 @@ void cmTarget::SetMakefile(cmMakefile* mf)
     this->SetPropertyDefault("POSITION_INDEPENDENT_CODE", 0);
     }
 
-  // Record current policies for later use.
-#define CAPTURE_TARGET_POLICY(POLICY) \
-  this->PolicyStatus ## POLICY = \
-    this->Makefile->GetPolicyStatus(cmPolicies::POLICY);
-
-  CM_FOR_EACH_TARGET_POLICY(CAPTURE_TARGET_POLICY)
-
-#undef CAPTURE_TARGET_POLICY
-
   if (this->TargetTypeValue == INTERFACE_LIBRARY)
     {
     // This policy is checked in a few conditions. The properties relevant
@@ -539,6 +706,7 @@ void cmTarget::ClearLinkMaps()
   this->Internal->LinkInterfaceUsageRequirementsOnlyMap.clear();
   this->Internal->LinkClosureMap.clear();
   this->Internal->SourceFilesMap.clear();
+  this->Internal->ClearUsageRequirementsCaches();
   cmDeleteAll(this->LinkInformation);
   this->LinkInformation.clear();
 }
@@ -1275,18 +1443,17 @@ void cmTarget::GetTllSignatureTraces(std::ostringstream &s,
     for(std::vector<cmListFileBacktrace>::iterator it = sigs.begin();
         it != sigs.end(); ++it)
       {
-      it->MakeRelative();
-      cmListFileBacktrace::const_iterator i = it->begin();
-      if(i != it->end())
+      if(!it->Empty())
         {
-        cmListFileContext const& lfc = *i;
+        cmListFileContext lfc = it->Top();
+        lfc.FilePath = this->Makefile->GetLocalGenerator()
+          ->Convert(lfc.FilePath, cmLocalGenerator::HOME);
         std::ostringstream line;
         line << " * " << (lfc.Line? "": " in ") << lfc << std::endl;
         if (emitted.insert(line.str()).second)
           {
           s << line.str();
           }
-        ++i;
         }
       }
     }
@@ -1795,8 +1962,8 @@ void cmTarget::SetProperty(const std::string& prop, const char* value)
   else
     {
     this->Properties.SetProperty(prop, value, cmProperty::TARGET);
-    this->MaybeInvalidatePropertyCache(prop);
     }
+  this->MaybeInvalidatePropertyCache(prop);
 }
 
 //----------------------------------------------------------------------------
@@ -1880,8 +2047,8 @@ void cmTarget::AppendProperty(const std::string& prop, const char* value,
   else
     {
     this->Properties.AppendProperty(prop, value, cmProperty::TARGET, asString);
-    this->MaybeInvalidatePropertyCache(prop);
     }
+  this->MaybeInvalidatePropertyCache(prop);
 }
 
 //----------------------------------------------------------------------------
@@ -1948,6 +2115,7 @@ void cmTarget::InsertInclude(const cmValueWithOrigin &entry,
 
   this->Internal->IncludeDirectoriesEntries.insert(position,
       new cmTargetInternals::TargetPropertyEntry(ge.Parse(entry.Value)));
+  this->Internal->ClearUsageRequirementsCaches();
 }
 
 //----------------------------------------------------------------------------
@@ -1962,6 +2130,7 @@ void cmTarget::InsertCompileOption(const cmValueWithOrigin &entry,
 
   this->Internal->CompileOptionsEntries.insert(position,
       new cmTargetInternals::TargetPropertyEntry(ge.Parse(entry.Value)));
+  this->Internal->ClearUsageRequirementsCaches();
 }
 
 //----------------------------------------------------------------------------
@@ -1971,6 +2140,7 @@ void cmTarget::InsertCompileDefinition(const cmValueWithOrigin &entry)
 
   this->Internal->CompileDefinitionsEntries.push_back(
       new cmTargetInternals::TargetPropertyEntry(ge.Parse(entry.Value)));
+  this->Internal->ClearUsageRequirementsCaches();
 }
 
 //----------------------------------------------------------------------------
@@ -1992,12 +2162,10 @@ static void processIncludeDirectories(cmTarget const* tgt,
     bool const fromImported = item.Target && item.Target->IsImported();
     bool const checkCMP0027 = item.FromGenex;
     std::vector<std::string> entryIncludes;
-    cmSystemTools::ExpandListArgument((*it)->ge->Evaluate(mf,
-                                              config,
-                                              false,
-                                              tgt,
-                                              dagChecker, language),
-                                    entryIncludes);
+    cmSystemTools::ExpandListArgument(
+      cmTargetInternals::EvaluateEntry(tgt, **it, dagChecker,
+                                       config, language),
+      entryIncludes);
 
     std::string usedIncludes;
     for(std::vector<std::string>::iterator
@@ -2111,6 +2279,12 @@ cmTarget::GetIncludeDirectories(const std::string& config,
                                 const std::string& language) const
 {
   std::vector<std::string> includes;
+  if (this->Internal->IncludeDirectoriesCache.Lookup(config, language,
+                                                     includes))
+    {
+    return includes;
+    }
+
   UNORDERED_SET<std::string> uniqueIncludes;
 
   cmGeneratorExpressionDAGChecker dagChecker(this->GetName(),
@@ -2187,6 +2361,8 @@ cmTarget::GetIncludeDirectories(const std::string& config,
 
   deleteAndClear(linkInterfaceIncludeDirectoriesEntries);
 
+  this->Internal->IncludeDirectoriesCache.Store(this->Makefile, config,
+                                                language, includes, 0);
   return includes;
 }
 
@@ -2205,13 +2381,10 @@ static void processCompileOptionsInternal(cmTarget const* tgt,
       it = entries.begin(), end = entries.end(); it != end; ++it)
     {
     std::vector<std::string> entryOptions;
-    cmSystemTools::ExpandListArgument((*it)->ge->Evaluate(mf,
-                                              config,
-                                              false,
-                                              tgt,
-                                              dagChecker,
-                                              language),
-                                    entryOptions);
+    cmSystemTools::ExpandListArgument(
+      cmTargetInternals::EvaluateEntry(tgt, **it, dagChecker,
+                                       config, language),
+      entryOptions);
     std::string usedOptions;
     for(std::vector<std::string>::iterator
           li = entryOptions.begin(); li != entryOptions.end(); ++li)
@@ -2282,6 +2455,12 @@ void cmTarget::GetCompileOptions(std::vector<std::string> &result,
                                  const std::string& config,
                                  const std::string& language) const
 {
+  if (this->Internal->CompileOptionsCache.Lookup(config, language, result))
+    {
+    return;
+    }
+  size_t const start = result.size();
+
   UNORDERED_SET<std::string> uniqueOptions;
 
   cmGeneratorExpressionDAGChecker dagChecker(this->GetName(),
@@ -2332,6 +2511,9 @@ void cmTarget::GetCompileOptions(std::vector<std::string> &result,
                             language);
 
   deleteAndClear(linkInterfaceCompileOptionsEntries);
+
+  this->Internal->CompileOptionsCache.Store(this->Makefile, config,
+                                            language, result, start);
 }
 
 //----------------------------------------------------------------------------
@@ -2353,6 +2535,12 @@ void cmTarget::GetCompileDefinitions(std::vector<std::string> &list,
                                             const std::string& config,
                                             const std::string& language) const
 {
+  if (this->Internal->CompileDefinitionsCache.Lookup(config, language, list))
+    {
+    return;
+    }
+  size_t const start = list.size();
+
   UNORDERED_SET<std::string> uniqueOptions;
 
   cmGeneratorExpressionDAGChecker dagChecker(this->GetName(),
@@ -2435,6 +2623,9 @@ void cmTarget::GetCompileDefinitions(std::vector<std::string> &list,
                             language);
 
   deleteAndClear(linkInterfaceCompileDefinitionsEntries);
+
+  this->Internal->CompileDefinitionsCache.Store(this->Makefile, config,
+                                                language, list, start);
 }
 
 //----------------------------------------------------------------------------
@@ -2454,6 +2645,13 @@ static void processCompileFeatures(cmTarget const* tgt,
 void cmTarget::GetCompileFeatures(std::vector<std::string> &result,
                                   const std::string& config) const
 {
+  if (this->Internal->CompileFeaturesCache.Lookup(config, std::string(),
+                                                  result))
+    {
+    return;
+    }
+  size_t const start = result.size();
+
   UNORDERED_SET<std::string> uniqueFeatures;
 
   cmGeneratorExpressionDAGChecker dagChecker(this->GetName(),
@@ -2502,11 +2700,18 @@ void cmTarget::GetCompileFeatures(std::vector<std::string> &result,
                             debugFeatures);
 
   deleteAndClear(linkInterfaceCompileFeaturesEntries);
+
+  this->Internal->CompileFeaturesCache.Store(this->Makefile, config,
+                                             std::string(), result, start);
 }
 
 //----------------------------------------------------------------------------
 void cmTarget::MaybeInvalidatePropertyCache(const std::string& prop)
 {
+  // Any property may be read by the generator expressions in the usage
+  // requirements of this target.
+  this->Internal->ClearUsageRequirementsCaches();
+
   // Wipe out maps caching information affected by this property.
   if(this->IsImported() && cmHasLiteralPrefix(prop, "IMPORTED"))
     {
@@ -6209,7 +6414,7 @@ void cmTargetInternals::AddInterfaceEntries(
         cmsys::auto_ptr<cmCompiledGeneratorExpression> cge = ge.Parse(genex);
         cge->SetEvaluateForBuildsystem(true);
         entries.push_back(
-          new cmTargetInternals::TargetPropertyEntry(cge, *it));
+          new cmTargetInternals::TargetPropertyEntry(cge, *it, prop));
         }
       }
     }
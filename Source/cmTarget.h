@@ -269,6 +269,11 @@ public:
   {
     // Libraries listed in the interface.
     std::vector<cmLinkItem> Libraries;
+
+    // Whether the libraries depend on the head target.
+    bool HadHeadSensitiveCondition;
+
+    LinkInterfaceLibraries(): HadHeadSensitiveCondition(false) {}
   };
   struct LinkInterface: public LinkInterfaceLibraries
   {
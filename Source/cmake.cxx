@@ -20,6 +20,8 @@
 #include "cmSourceFile.h"
 #include "cmTest.h"
 #include "cmDocumentationFormatter.h"
+#include "cmMakefileProfilingData.h"
+#include "cmRegularExpressionCache.h"
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 # include "cmGraphVizWriter.h"
@@ -128,6 +130,7 @@ cmake::cmake()
   this->DebugTryCompile = false;
   this->ClearBuildSystem = false;
   this->FileComparison = new cmFileTimeComparison;
+  this->ProfilingOutput = 0;
 
   this->Policies = new cmPolicies();
   this->InitializeProperties();
@@ -179,6 +182,7 @@ cmake::~cmake()
   delete this->VariableWatch;
 #endif
   delete this->FileComparison;
+  delete this->ProfilingOutput;
 }
 
 void cmake::InitializeProperties()
@@ -725,6 +729,27 @@ void cmake::SetArgs(const std::vector<std::string>& args,
         cmSystemTools::Error("No file specified for --graphviz");
         }
       }
+    else if(arg.find("--profiling-output=",0) == 0)
+      {
+      std::string path = arg.substr(strlen("--profiling-output="));
+      if(path.empty())
+        {
+        cmSystemTools::Error("No file specified for --profiling-output");
+        }
+      else
+        {
+        path = cmSystemTools::CollapseFullPath(path);
+        delete this->ProfilingOutput;
+        this->ProfilingOutput = new cmMakefileProfilingData(path);
+        if(!this->ProfilingOutput->IsValid())
+          {
+          cmSystemTools::Error("Could not open --profiling-output file ",
+                               path.c_str());
+          delete this->ProfilingOutput;
+          this->ProfilingOutput = 0;
+          }
+        }
+      }
     else if(arg.find("--debug-trycompile",0) == 0)
       {
       std::cout << "debug trycompile on\n";
@@ -1629,6 +1654,20 @@ void cmake::PreLoadCMakeFiles()
     }
 }
 
+//----------------------------------------------------------------------------
+void cmake::PrintTraceSummary()
+{
+  if(!this->GetTrace())
+    {
+    return;
+    }
+  std::ostringstream msg;
+  msg << "Regular expression cache: "
+      << cmRegularExpressionCache::GetHits() << " hits, "
+      << cmRegularExpressionCache::GetMisses() << " misses";
+  cmSystemTools::Message(msg.str().c_str());
+}
+
 // handle a command line invocation
 int cmake::Run(const std::vector<std::string>& args, bool noconfigure)
 {
@@ -1676,6 +1715,7 @@ int cmake::Run(const std::vector<std::string>& args, bool noconfigure)
   // In script mode we terminate after running the script.
   if(this->GetWorkingMode() != NORMAL_MODE)
     {
+    this->PrintTraceSummary();
     if(cmSystemTools::GetErrorOccuredFlag())
       {
       return -1;
@@ -1717,6 +1757,7 @@ int cmake::Run(const std::vector<std::string>& args, bool noconfigure)
   this->SetStartDirectory(this->GetHomeDirectory());
   this->SetStartOutputDirectory(this->GetHomeOutputDirectory());
   int ret = this->Configure();
+  this->PrintTraceSummary();
   if (ret || this->GetWorkingMode() != NORMAL_MODE)
     {
 #if defined(CMAKE_HAVE_VS_GENERATORS)
@@ -2141,6 +2182,24 @@ int cmake::CheckBuildSystem()
     }
   }
 
+  // Check the dependencies of all targets in this process so that
+  // their depend rules need not run cmake_depends.
+  if(mf->IsOn("CMAKE_DEPENDS_BATCH"))
+    {
+    const char* genName = mf->GetDefinition("CMAKE_DEPENDS_GENERATOR");
+    if(!genName || genName[0] == '\0')
+      {
+      genName = "Unix Makefiles";
+      }
+    cmsys::auto_ptr<cmGlobalGenerator>
+      ggd(this->CreateGlobalGenerator(genName));
+    if(ggd.get())
+      {
+      cmsys::auto_ptr<cmLocalGenerator> lgd(ggd->CreateLocalGenerator());
+      lgd->CheckDependencies(mf, verbose);
+      }
+    }
+
   // No need to rerun.
   return 0;
 }
@@ -2609,11 +2668,8 @@ static bool cmakeCheckStampList(const char* stampList)
 
 //----------------------------------------------------------------------------
 void cmake::IssueMessage(cmake::MessageType t, std::string const& text,
-                         cmListFileBacktrace const& bt)
+                         cmListFileBacktrace const& backtrace)
 {
-  cmListFileBacktrace backtrace = bt;
-  backtrace.MakeRelative();
-
   std::ostringstream msg;
   bool isError = false;
   // Construct the message header.
@@ -2657,13 +2713,7 @@ void cmake::IssueMessage(cmake::MessageType t, std::string const& text,
     }
 
   // Add the immediate context.
-  cmListFileBacktrace::const_iterator i = backtrace.begin();
-  if(i != backtrace.end())
-    {
-    cmListFileContext const& lfc = *i;
-    msg << (lfc.Line? " at ": " in ") << lfc;
-    ++i;
-    }
+  backtrace.PrintTitle(msg);
 
   // Add the message text.
   {
@@ -2674,16 +2724,7 @@ void cmake::IssueMessage(cmake::MessageType t, std::string const& text,
   }
 
   // Add the rest of the context.
-  if(i != backtrace.end())
-    {
-    msg << "Call Stack (most recent call first):\n";
-    while(i != backtrace.end())
-      {
-      cmListFileContext const& lfc = *i;
-      msg << "  " << lfc << "\n";
-      ++i;
-      }
-    }
+  backtrace.PrintCallStack(msg);
 
   // Add a note about warning suppression.
   if(t == cmake::AUTHOR_WARNING)
@@ -27,6 +27,7 @@ class cmMakefile;
 class cmCommand;
 class cmVariableWatch;
 class cmFileTimeComparison;
+class cmMakefileProfilingData;
 class cmExternalMakefileProjectGenerator;
 class cmDocumentationSection;
 class cmPolicies;
@@ -326,6 +327,10 @@ class cmake
   // Do we want trace output during the cmake run.
   bool GetTrace() { return this->Trace;}
   void SetTrace(bool b) {  this->Trace = b;}
+
+  // The data recording command execution times, if profiling.
+  cmMakefileProfilingData* GetProfilingOutput()
+    { return this->ProfilingOutput; }
   bool GetWarnUninitialized() { return this->WarnUninitialized;}
   void SetWarnUninitialized(bool b) {  this->WarnUninitialized = b;}
   bool GetWarnUnused() { return this->WarnUnused;}
@@ -463,11 +468,15 @@ private:
   bool ClearBuildSystem;
   bool DebugTryCompile;
   cmFileTimeComparison* FileComparison;
+  cmMakefileProfilingData* ProfilingOutput;
   std::string GraphVizFile;
   std::vector<std::string> DebugConfigs;
   InstalledFilesMap InstalledFiles;
 
   void UpdateConversionPathTable();
+
+  // Print statistics gathered while tracing.
+  void PrintTraceSummary();
 };
 
 #define CMAKE_STANDARD_OPTIONS_TABLE \
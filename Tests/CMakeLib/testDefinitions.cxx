@@ -0,0 +1,76 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmake.h"
+#include "cmGlobalGenerator.h"
+#include "cmLocalGenerator.h"
+#include "cmMakefile.h"
+
+#include <cmsys/auto_ptr.hxx>
+
+static std::string testDefinitionsValue(int i)
+{
+  // Long enough not to be stored inside the string object itself.
+  std::ostringstream value;
+  value << "value of a definition held across subdirectories #" << i;
+  return value.str();
+}
+
+// Hold the values returned by GetDefinition while subdirectories are
+// initialized from the scope, which shares its definitions with them.
+int testDefinitions(int, char*[])
+{
+  cmake cm;
+  cmsys::auto_ptr<cmGlobalGenerator> gg(new cmGlobalGenerator);
+  gg->SetCMakeInstance(&cm);
+  cmsys::auto_ptr<cmLocalGenerator> lg(gg->CreateLocalGenerator());
+  cmMakefile* mf = lg->GetMakefile();
+
+  std::vector<cmLocalGenerator*> subdirs;
+  std::vector<const char*> held;
+  for(int i = 0; i < 64; ++i)
+    {
+    std::ostringstream name;
+    name << "VAR" << i;
+    mf->AddDefinition(name.str(), testDefinitionsValue(i).c_str());
+    mf->RemoveDefinition("UNSET");
+    held.push_back(mf->GetDefinition(name.str()));
+
+    cmLocalGenerator* lg2 = gg->CreateLocalGenerator();
+    lg2->SetParent(lg.get());
+    lg2->GetMakefile()->InitializeFromParent();
+    subdirs.push_back(lg2);
+    }
+
+  // Reuse any memory freed meanwhile.
+  std::vector<std::string> filler;
+  for(int i = 0; i < 1024; ++i)
+    {
+    filler.push_back(std::string(testDefinitionsValue(0).size(), 'x'));
+    }
+
+  int result = 0;
+  for(int i = 0; i < 64; ++i)
+    {
+    if(testDefinitionsValue(i) != held[i])
+      {
+      std::cout << "Definition " << i << " changed to \"" << held[i]
+                << "\"\n";
+      result = 1;
+      }
+    }
+  for(std::vector<cmLocalGenerator*>::iterator si = subdirs.begin();
+      si != subdirs.end(); ++si)
+    {
+    delete *si;
+    }
+  return result;
+}
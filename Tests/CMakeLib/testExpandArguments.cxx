@@ -0,0 +1,100 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmake.h"
+#include "cmGlobalGenerator.h"
+#include "cmLocalGenerator.h"
+#include "cmMakefile.h"
+
+#include <cmsys/auto_ptr.hxx>
+
+// The arguments of the body of a typical foreach loop.
+static const char* const bodyArguments[] = {
+  "${prefix}_${item}",
+  "${item}.c",
+  "${CMAKE_CURRENT_SOURCE_DIR}/src/${item}/${item}.c",
+  "-D${prefix}_${item}_ENABLED=\\\"${${item}_value}\\\"",
+  "lib${item}\\;${item}_extra",
+  "plain literal text without references",
+  "$ENV{HOME}/${item}/\\$notavariable",
+  0
+};
+
+typedef std::vector<cmListFileArgument> testExpandArgumentsList;
+
+static double testExpandArgumentsRun(
+  cmMakefile* mf, std::vector<testExpandArgumentsList> const& lists,
+  int iterations, std::vector<std::string>& out)
+{
+  double start = cmSystemTools::GetTime();
+  for(int i = 0; i < iterations; ++i)
+    {
+    std::ostringstream item;
+    item << "item" << (i % 10);
+    mf->AddDefinition("item", item.str().c_str());
+    out.clear();
+    mf->ExpandArguments(lists[i % lists.size()], out);
+    }
+  return cmSystemTools::GetTime() - start;
+}
+
+// Expand the same arguments repeatedly, both from their parsed tokens
+// and from their text, and report the time taken by each.
+int testExpandArguments(int, char*[])
+{
+  cmake cm;
+  cmsys::auto_ptr<cmGlobalGenerator> gg(new cmGlobalGenerator);
+  gg->SetCMakeInstance(&cm);
+  cmsys::auto_ptr<cmLocalGenerator> lg(gg->CreateLocalGenerator());
+  cmMakefile* mf = lg->GetMakefile();
+  mf->SetPolicy(cmPolicies::CMP0053, cmPolicies::NEW);
+  mf->AddDefinition("prefix", "PROJ");
+  mf->AddDefinition("CMAKE_CURRENT_SOURCE_DIR", "/path/to/source");
+  for(int i = 0; i < 10; ++i)
+    {
+    std::ostringstream name;
+    name << "item" << i << "_value";
+    mf->AddDefinition(name.str(), "value");
+    }
+
+  // Arguments expanded repeatedly are parsed into tokens, those expanded
+  // only once are expanded from their text.
+  testExpandArgumentsList args;
+  for(const char* const* a = bodyArguments; *a; ++a)
+    {
+    args.push_back(cmListFileArgument(*a, cmListFileArgument::Unquoted,
+                                      "testExpandArguments", 1));
+    }
+
+  const int iterations = 20000;
+  std::vector<testExpandArgumentsList> parsed(1, args);
+  std::vector<testExpandArgumentsList> text(iterations, args);
+  std::vector<std::string> parsedOut;
+  std::vector<std::string> textOut;
+  double parsedTime =
+    testExpandArgumentsRun(mf, parsed, iterations, parsedOut);
+  double textTime = testExpandArgumentsRun(mf, text, iterations, textOut);
+
+  if(parsedOut != textOut)
+    {
+    std::cout << "Expansion from tokens differs from expansion of text:\n";
+    for(size_t i = 0; i < parsedOut.size() && i < textOut.size(); ++i)
+      {
+      std::cout << "  [" << parsedOut[i] << "] [" << textOut[i] << "]\n";
+      }
+    return 1;
+    }
+  std::cout << iterations << " expansions of " << args.size()
+            << " arguments:\n"
+            << "  from tokens: " << parsedTime << "s\n"
+            << "  from text:   " << textTime << "s\n";
+  return 0;
+}
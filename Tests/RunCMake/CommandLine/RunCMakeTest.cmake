@@ -73,6 +73,12 @@ run_cmake_command(E_sleep-one-tenth ${CMAKE_COMMAND} -E sleep 0.1)
 
 run_cmake_command(P_directory ${CMAKE_COMMAND} -P ${RunCMake_SOURCE_DIR})
 
+run_cmake_command(trace-regex-cache
+  ${CMAKE_COMMAND} --trace -P ${RunCMake_SOURCE_DIR}/trace-regex-cache.cmake)
+
+run_cmake_command(profiling-output ${CMAKE_COMMAND}
+  --profiling-output=profile.json -P ${RunCMake_SOURCE_DIR}/profiling-output.cmake)
+
 set(RunCMake_TEST_OPTIONS
   "-DFOO=-DBAR:BOOL=BAZ")
 run_cmake(D_nested_cache)
@@ -0,0 +1,19 @@
+set(profile "${RunCMake_TEST_BINARY_DIR}/profile.json")
+if(NOT EXISTS "${profile}")
+  set(RunCMake_TEST_FAILED "Profiling output file not written:\n  ${profile}")
+  return()
+endif()
+file(READ "${profile}" content)
+if(NOT content MATCHES "^\\[\n{\"name\":\"function\"")
+  set(RunCMake_TEST_FAILED "Profiling output does not start with an event:\n${content}")
+elseif(NOT content MATCHES "\"name\":\"profiled_function\"[^\n]*\"location\":\"[^\"]*/profiling-output.cmake:4\"")
+  set(RunCMake_TEST_FAILED "Profiling output does not record the function call:\n${content}")
+else()
+  string(REGEX MATCHALL "\"ph\":\"B\"" begin "${content}")
+  string(REGEX MATCHALL "\"ph\":\"E\"" end "${content}")
+  list(LENGTH begin nbegin)
+  list(LENGTH end nend)
+  if(NOT nbegin EQUAL 3 OR NOT nend EQUAL 3)
+    set(RunCMake_TEST_FAILED "Profiling output has ${nbegin} begin and ${nend} end events instead of 3:\n${content}")
+  endif()
+endif()
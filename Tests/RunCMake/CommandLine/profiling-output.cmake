@@ -0,0 +1,4 @@
+function(profiled_function)
+  set(value 1)
+endfunction()
+profiled_function()
@@ -0,0 +1,5 @@
+foreach(i 1 2 3)
+  if("v${i}" MATCHES "^v([0-9])$")
+    string(REGEX REPLACE "[0-9]" "x" out "${CMAKE_MATCH_1}")
+  endif()
+endforeach()
@@ -0,0 +1,32 @@
+if(NOT EXISTS "${serial_dir}")
+  return()
+endif()
+
+# Compare the build system files, not those of the compiler checks or
+# the cache, which records the option itself.
+set(exclude "^(CMakeCache\\.txt|CMakeFiles/([0-9]|CMakeTmp|CMake[A-Za-z]*\\.log))")
+foreach(dir serial_dir RunCMake_TEST_BINARY_DIR)
+  file(GLOB_RECURSE files RELATIVE "${${dir}}" "${${dir}}/*")
+  set(${dir}_files)
+  foreach(f IN LISTS files)
+    if(NOT f MATCHES "${exclude}")
+      list(APPEND ${dir}_files "${f}")
+    endif()
+  endforeach()
+  list(SORT ${dir}_files)
+endforeach()
+
+if(NOT serial_dir_files STREQUAL RunCMake_TEST_BINARY_DIR_files)
+  set(RunCMake_TEST_FAILED "Generated files differ:\n"
+    "  ${serial_dir_files}\n"
+    "  ${RunCMake_TEST_BINARY_DIR_files}")
+  return()
+endif()
+foreach(f IN LISTS serial_dir_files)
+  file(READ "${serial_dir}/${f}" serial)
+  file(READ "${RunCMake_TEST_BINARY_DIR}/${f}" precomputed)
+  if(NOT precomputed STREQUAL serial)
+    set(RunCMake_TEST_FAILED "Generated file differs:\n  ${f}")
+    return()
+  endif()
+endforeach()
@@ -0,0 +1,8 @@
+enable_language(C)
+add_subdirectory(sub)
+add_library(obj OBJECT obj.c)
+add_library(static STATIC $<TARGET_OBJECTS:obj>)
+add_executable(main main.c)
+target_link_libraries(main sub static)
+target_compile_definitions(main PRIVATE
+  MAIN_LINKS=$<JOIN:$<TARGET_PROPERTY:main,LINK_LIBRARIES>,+>)
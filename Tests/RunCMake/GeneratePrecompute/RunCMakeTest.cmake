@@ -0,0 +1,14 @@
+include(RunCMake)
+
+function(run_Precompute)
+  # Generate the project without and then with precomputing the target
+  # information in the same build tree.  The check compares the trees.
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Precompute-build)
+  set(serial_dir ${RunCMake_BINARY_DIR}/Precompute-serial)
+  file(REMOVE_RECURSE "${serial_dir}")
+  run_cmake(Precompute)
+  file(RENAME "${RunCMake_TEST_BINARY_DIR}" "${serial_dir}")
+  set(RunCMake_TEST_OPTIONS -DCMAKE_GENERATE_PRECOMPUTE=ON)
+  run_cmake(Precompute)
+endfunction()
+run_Precompute()
@@ -0,0 +1,6 @@
+extern int sub(void);
+extern int obj(void);
+int main(void)
+{
+  return sub() + obj();
+}
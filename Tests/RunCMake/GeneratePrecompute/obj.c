@@ -0,0 +1,4 @@
+int obj(void)
+{
+  return 0;
+}
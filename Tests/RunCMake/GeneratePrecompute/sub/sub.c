@@ -0,0 +1,5 @@
+#include "sub.h"
+int sub(void)
+{
+  return SUB_VALUE;
+}
@@ -0,0 +1 @@
+#define SUB_VALUE 0
@@ -0,0 +1,8 @@
+set(dir "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/BatchDepends.dir")
+if(EXISTS "${dir}/depend.valid")
+  set(RunCMake_TEST_FAILED "depend.valid exists before the first scan.")
+endif()
+file(READ "${dir}/DependInfo.cmake" info)
+if(NOT info MATCHES "set\\(CMAKE_DEPENDS_BATCH 1\\)")
+  set(RunCMake_TEST_FAILED "DependInfo.cmake does not enable batch checks.")
+endif()
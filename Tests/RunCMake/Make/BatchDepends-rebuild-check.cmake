@@ -0,0 +1,4 @@
+set(dir "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/BatchDepends.dir")
+if(NOT EXISTS "${dir}/depend.valid")
+  set(RunCMake_TEST_FAILED "depend.valid not created by the build system check.")
+endif()
@@ -0,0 +1,5 @@
+enable_language(C)
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/BatchDepends.h "#define VALUE 0\n")
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/BatchDepends.c
+  "#include \"BatchDepends.h\"\nint BatchDepends(void) { return VALUE; }\n")
+add_library(BatchDepends STATIC ${CMAKE_CURRENT_BINARY_DIR}/BatchDepends.c)
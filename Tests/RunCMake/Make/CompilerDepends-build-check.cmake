@@ -0,0 +1,5 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/DepfileFlags.txt" flags)
+set(obj "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/CompilerDepends.dir/CompilerDepends.c.o")
+if(flags AND NOT EXISTS "${obj}.d")
+  set(RunCMake_TEST_FAILED "Compiler did not write\n  ${obj}.d")
+endif()
@@ -0,0 +1,11 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/DepfileFlags.txt" flags)
+set(dir "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/CompilerDepends.dir")
+file(READ "${dir}/depend.make" depends)
+if(flags AND NOT depends MATCHES "CompilerDepends\\.h")
+  set(RunCMake_TEST_FAILED
+    "Header included through a macro is missing from depend.make:\n${depends}")
+elseif(NOT depends MATCHES "CompilerDependsSystem\\.h")
+  set(RunCMake_TEST_FAILED
+    "Header in a SYSTEM include directory is missing from depend.make:\n"
+    "${depends}")
+endif()
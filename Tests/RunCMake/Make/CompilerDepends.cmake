@@ -0,0 +1,11 @@
+enable_language(C)
+set(dir ${CMAKE_CURRENT_BINARY_DIR})
+file(WRITE ${dir}/CompilerDepends.h "#define VALUE 0\n")
+file(WRITE ${dir}/system/CompilerDependsSystem.h "#define SYSTEM_VALUE 0\n")
+file(WRITE ${dir}/CompilerDepends.c
+  "#define HEADER \"CompilerDepends.h\"\n#include HEADER\n"
+  "#include <CompilerDependsSystem.h>\n"
+  "int CompilerDepends(void) { return VALUE + SYSTEM_VALUE; }\n")
+add_library(CompilerDepends STATIC ${dir}/CompilerDepends.c)
+target_include_directories(CompilerDepends SYSTEM PRIVATE ${dir}/system)
+file(WRITE ${dir}/DepfileFlags.txt "${CMAKE_MAKEFILE_DEPFILE_FLAGS_C}")
@@ -0,0 +1,14 @@
+set(cache "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/C.includecache")
+file(READ "${cache}" content)
+string(REGEX MATCHALL "\n\n[^\n]*/IncludeCache\\.h\n[0-9]+\n"
+  entries "${content}")
+list(LENGTH entries count)
+if(NOT count EQUAL 3)
+  set(RunCMake_TEST_FAILED
+    "The shared cache has ${count} entries for IncludeCache.h, not 3.")
+  return()
+endif()
+file(STRINGS "${cache}" entries REGEX "/IncludeCacheExtra\\.h$")
+if(NOT entries)
+  set(RunCMake_TEST_FAILED "The shared cache was rewritten too early.")
+endif()
@@ -0,0 +1,20 @@
+set(cache "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/C.includecache")
+if(NOT EXISTS "${cache}")
+  set(RunCMake_TEST_FAILED "The shared include cache was not written.")
+  return()
+endif()
+foreach(t a b)
+  set(dir "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/IncludeCache_${t}.dir")
+  if(EXISTS "${dir}/C.includecache")
+    set(RunCMake_TEST_FAILED "Target ${t} did not use the shared cache.")
+    return()
+  endif()
+endforeach()
+file(READ "${cache}" content)
+string(REGEX MATCHALL "\n\n[^\n]*/IncludeCache\\.h\n[0-9]+\n"
+  entries "${content}")
+list(LENGTH entries count)
+if(NOT count EQUAL 1)
+  set(RunCMake_TEST_FAILED
+    "The shared cache has ${count} entries for IncludeCache.h.")
+endif()
@@ -0,0 +1,14 @@
+foreach(t a b)
+  set(dir "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/IncludeCache_${t}.dir")
+  file(STRINGS "${dir}/depend.internal" lines
+    REGEX "/IncludeCacheExtra\\.h$")
+  if(NOT lines)
+    set(RunCMake_TEST_FAILED "Target ${t} was not rescanned.")
+    return()
+  endif()
+endforeach()
+set(cache "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/C.includecache")
+file(STRINGS "${cache}" entries REGEX "/IncludeCacheExtra\\.h$")
+if(NOT entries)
+  set(RunCMake_TEST_FAILED "The shared cache does not list the new header.")
+endif()
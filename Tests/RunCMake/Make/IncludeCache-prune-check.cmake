@@ -0,0 +1,22 @@
+set(cache "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/C.includecache")
+file(STRINGS "${cache}" entries REGEX "IncludeCacheExtra\\.h$")
+if(entries)
+  set(RunCMake_TEST_FAILED
+    "The shared cache still lists the removed IncludeCacheExtra.h.")
+  return()
+endif()
+file(READ "${cache}" content)
+string(REGEX MATCHALL "\n\n[^\n]*/IncludeCache\\.h\n[0-9]+\n"
+  entries "${content}")
+list(LENGTH entries count)
+if(NOT count EQUAL 1)
+  set(RunCMake_TEST_FAILED
+    "The compacted cache has ${count} entries for IncludeCache.h.")
+  return()
+endif()
+set(depends
+  "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/IncludeCache_b.dir/depend.internal")
+file(STRINGS "${depends}" lines REGEX "/IncludeCache\\.h$")
+if(NOT lines)
+  set(RunCMake_TEST_FAILED "Target b lost its dependency on IncludeCache.h.")
+endif()
@@ -0,0 +1,6 @@
+set(depends
+  "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/IncludeCache_b.dir/depend.internal")
+file(STRINGS "${depends}" lines REGEX "/IncludeCache\\.h$")
+if(NOT lines)
+  set(RunCMake_TEST_FAILED "Target b lost its dependency on IncludeCache.h.")
+endif()
@@ -0,0 +1,8 @@
+enable_language(C)
+set(dir ${CMAKE_CURRENT_BINARY_DIR})
+file(WRITE ${dir}/IncludeCache.h "#define VALUE 0\n")
+foreach(t a b)
+  file(WRITE ${dir}/IncludeCache_${t}.c
+    "#include \"IncludeCache.h\"\nint ${t}(void) { return VALUE; }\n")
+  add_library(IncludeCache_${t} STATIC ${dir}/IncludeCache_${t}.c)
+endforeach()
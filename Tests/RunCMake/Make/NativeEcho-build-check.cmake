@@ -0,0 +1,6 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/NativeEcho.dir/build.make"
+  build_make)
+if(build_make MATCHES "cmake_echo_color")
+  set(RunCMake_TEST_FAILED
+    "build.make runs cmake_echo_color:\n${build_make}")
+endif()
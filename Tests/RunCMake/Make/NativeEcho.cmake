@@ -0,0 +1,5 @@
+add_custom_command(OUTPUT output.txt
+  COMMAND ${CMAKE_COMMAND} -E touch output.txt
+  COMMENT "Generating output.txt"
+  )
+add_custom_target(NativeEcho ALL DEPENDS output.txt)
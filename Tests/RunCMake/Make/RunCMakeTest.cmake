@@ -0,0 +1,110 @@
+include(RunCMake)
+
+function(run_NativeEcho)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/NativeEcho-build)
+  set(RunCMake_TEST_OPTIONS -DCMAKE_MAKEFILE_NATIVE_ECHO=ON)
+  run_cmake(NativeEcho)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(RunCMake_TEST_COMMAND ${CMAKE_COMMAND} --build .)
+  run_cmake(NativeEcho-build)
+endfunction()
+run_NativeEcho()
+
+function(run_BatchDepends)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/BatchDepends-build)
+  set(RunCMake_TEST_OPTIONS -DCMAKE_MAKEFILE_BATCH_DEPENDS=ON)
+  run_cmake(BatchDepends)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(RunCMake_TEST_COMMAND ${CMAKE_COMMAND} --build .)
+  run_cmake(BatchDepends-build)
+  run_cmake(BatchDepends-rebuild)
+endfunction()
+run_BatchDepends()
+
+function(run_CompilerDepends)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/CompilerDepends-build)
+  set(RunCMake_TEST_OPTIONS -DCMAKE_MAKEFILE_COMPILER_DEPENDS=ON)
+  run_cmake(CompilerDepends)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(RunCMake_TEST_COMMAND ${CMAKE_COMMAND} --build .)
+  run_cmake(CompilerDepends-build)
+  run_cmake(CompilerDepends-rebuild)
+endfunction()
+run_CompilerDepends()
+
+function(run_IncludeCache)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/IncludeCache-build)
+  run_cmake(IncludeCache)
+  # Files modified within the second they are scanned are not cached.
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(RunCMake_TEST_COMMAND ${CMAKE_COMMAND} --build .)
+  run_cmake(IncludeCache-build)
+
+  # Scanning b again finds everything in the cache and leaves it alone.
+  set(cache ${RunCMake_TEST_BINARY_DIR}/CMakeFiles/C.includecache)
+  set(timeformat "%Y%j%H%M%S")
+  file(TIMESTAMP "${cache}" timestamp ${timeformat})
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  file(REMOVE
+    ${RunCMake_TEST_BINARY_DIR}/CMakeFiles/IncludeCache_b.dir/depend.internal)
+  run_cmake(IncludeCache-reuse)
+  file(TIMESTAMP "${cache}" timestamp_after ${timeformat})
+  if(NOT timestamp OR NOT timestamp_after STREQUAL timestamp)
+    message(SEND_ERROR "Rescanning unchanged files rewrote \"${cache}\".")
+  endif()
+
+  # Editing the shared header rescans both targets.
+  file(WRITE ${RunCMake_TEST_BINARY_DIR}/IncludeCacheExtra.h "")
+  file(WRITE ${RunCMake_TEST_BINARY_DIR}/IncludeCache.h
+    "#include \"IncludeCacheExtra.h\"\n#define VALUE 1\n")
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  run_cmake(IncludeCache-edit)
+
+  # Rescanned files are appended to the cache, which keeps listing
+  # removed headers.
+  file(REMOVE ${RunCMake_TEST_BINARY_DIR}/IncludeCacheExtra.h)
+  file(WRITE ${RunCMake_TEST_BINARY_DIR}/IncludeCache.h "#define VALUE 2\n")
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  run_cmake(IncludeCache-append)
+
+  # Removed headers are dropped once the cache lists twice as many
+  # entries as files and is compacted.
+  file(WRITE ${RunCMake_TEST_BINARY_DIR}/IncludeCache.h "#define VALUE 3\n")
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  execute_process(COMMAND ${CMAKE_COMMAND} --build .
+    WORKING_DIRECTORY ${RunCMake_TEST_BINARY_DIR} OUTPUT_QUIET)
+  file(WRITE ${RunCMake_TEST_BINARY_DIR}/IncludeCache.h "#define VALUE 4\n")
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  run_cmake(IncludeCache-prune)
+endfunction()
+run_IncludeCache()
+
+function(run_SkipUnchanged)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/SkipUnchanged-build)
+  set(RunCMake_TEST_OPTIONS -DCMAKE_MAKEFILE_SKIP_UNCHANGED_DIRECTORIES=ON)
+  run_cmake(SkipUnchanged)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(RunCMake_TEST_COMMAND ${CMAKE_COMMAND} --build .)
+  run_cmake(SkipUnchanged-build)
+
+  # The first configuration checks the compilers, so run CMake again
+  # before the fingerprints are stable.
+  set(RunCMake_TEST_COMMAND ${CMAKE_COMMAND} .)
+  run_cmake(SkipUnchanged-rerun)
+
+  # Editing one directory writes its files again but not those of the
+  # other directory.
+  set(timeformat "%Y%j%H%M%S")
+  foreach(t a b)
+    set(f SkipUnchanged_${t}-build/CMakeFiles/Fingerprint.txt)
+    file(TIMESTAMP ${RunCMake_TEST_BINARY_DIR}/${f}
+      timestamp_${t} ${timeformat})
+  endforeach()
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  file(APPEND ${RunCMake_TEST_BINARY_DIR}/SkipUnchanged_b/CMakeLists.txt
+    "target_compile_definitions(SkipUnchanged_b PRIVATE VALUE=1)\n")
+  set(RunCMake_TEST_COMMAND ${CMAKE_COMMAND} --build .)
+  run_cmake(SkipUnchanged-edit)
+endfunction()
+run_SkipUnchanged()
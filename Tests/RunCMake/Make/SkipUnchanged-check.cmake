@@ -0,0 +1,10 @@
+set(dir ${RunCMake_TEST_BINARY_DIR})
+foreach(t a b)
+  set(f ${dir}/SkipUnchanged_${t}-build/CMakeFiles/Fingerprint.txt)
+  if(NOT EXISTS "${f}")
+    set(RunCMake_TEST_FAILED "Fingerprint not written:\n  ${f}")
+  endif()
+endforeach()
+if(EXISTS ${dir}/CMakeFiles/Fingerprint.txt)
+  set(RunCMake_TEST_FAILED "Fingerprint of the top directory written.")
+endif()
@@ -0,0 +1,15 @@
+set(dir ${RunCMake_TEST_BINARY_DIR})
+foreach(t a b)
+  file(TIMESTAMP ${dir}/SkipUnchanged_${t}-build/CMakeFiles/Fingerprint.txt
+    timestamp_after_${t} ${timeformat})
+endforeach()
+file(STRINGS
+  ${dir}/SkipUnchanged_b-build/CMakeFiles/SkipUnchanged_b.dir/flags.make
+  defines REGEX "VALUE=1")
+if(NOT timestamp_after_a OR NOT timestamp_after_a STREQUAL timestamp_a)
+  set(RunCMake_TEST_FAILED "Directory a was written again.")
+elseif(NOT timestamp_after_b OR timestamp_after_b STREQUAL timestamp_b)
+  set(RunCMake_TEST_FAILED "Directory b was not written again.")
+elseif(NOT defines)
+  set(RunCMake_TEST_FAILED "Directory b does not define VALUE.")
+endif()
@@ -0,0 +1,17 @@
+enable_language(C)
+set(dir ${CMAKE_CURRENT_BINARY_DIR})
+foreach(t a b)
+  # The test edits these files between runs.
+  if(NOT EXISTS ${dir}/SkipUnchanged_${t}/CMakeLists.txt)
+    file(WRITE ${dir}/SkipUnchanged_${t}/${t}.c
+      "int ${t}(void) { return 0; }\n")
+    file(WRITE ${dir}/SkipUnchanged_${t}/CMakeLists.txt
+      "add_library(SkipUnchanged_${t} STATIC ${t}.c)\n")
+  endif()
+  add_subdirectory(${dir}/SkipUnchanged_${t} SkipUnchanged_${t}-build)
+endforeach()
+file(WRITE ${dir}/SkipUnchanged.c
+  "extern int a(void);\nextern int b(void);\n"
+  "int main(void) { return a() + b(); }\n")
+add_executable(SkipUnchanged ${dir}/SkipUnchanged.c)
+target_link_libraries(SkipUnchanged SkipUnchanged_a SkipUnchanged_b)
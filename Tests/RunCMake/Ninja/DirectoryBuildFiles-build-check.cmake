@@ -0,0 +1,4 @@
+if(NOT EXISTS ${RunCMake_TEST_BINARY_DIR}/main AND
+   NOT EXISTS ${RunCMake_TEST_BINARY_DIR}/main.exe)
+  set(RunCMake_TEST_FAILED "Executable main was not built.")
+endif()
@@ -0,0 +1,7 @@
+file(READ ${RunCMake_TEST_BINARY_DIR}/build.ninja build)
+if(NOT build MATCHES "\nsubninja sub/CMakeFiles/directory\\.ninja\n")
+  set(RunCMake_TEST_FAILED
+    "build.ninja does not include sub/CMakeFiles/directory.ninja.")
+elseif(NOT EXISTS ${RunCMake_TEST_BINARY_DIR}/sub/CMakeFiles/directory.ninja)
+  set(RunCMake_TEST_FAILED "sub/CMakeFiles/directory.ninja does not exist.")
+endif()
@@ -0,0 +1,4 @@
+enable_language(C)
+add_subdirectory(sub)
+add_executable(main main.c)
+target_link_libraries(main sub)
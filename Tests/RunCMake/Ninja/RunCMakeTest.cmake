@@ -0,0 +1,23 @@
+include(RunCMake)
+
+function(run_DirectoryBuildFiles)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/DirectoryBuildFiles-build)
+  set(RunCMake_TEST_OPTIONS -DCMAKE_NINJA_DIRECTORY_BUILD_FILES=ON)
+  run_cmake(DirectoryBuildFiles)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(RunCMake_TEST_COMMAND ${CMAKE_COMMAND} --build .)
+  run_cmake(DirectoryBuildFiles-build)
+  unset(RunCMake_TEST_COMMAND)
+
+  # Regenerating without changes must leave the directory file alone.
+  set(file ${RunCMake_TEST_BINARY_DIR}/sub/CMakeFiles/directory.ninja)
+  set(timeformat "%Y%j%H%M%S")
+  file(TIMESTAMP "${file}" timestamp ${timeformat})
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  run_cmake(DirectoryBuildFiles)
+  file(TIMESTAMP "${file}" timestamp_after ${timeformat})
+  if(NOT timestamp OR NOT timestamp_after STREQUAL timestamp)
+    message(SEND_ERROR "Regenerating changed \"${file}\".")
+  endif()
+endfunction()
+run_DirectoryBuildFiles()
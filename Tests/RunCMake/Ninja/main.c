@@ -0,0 +1,5 @@
+extern int sub(void);
+int main(void)
+{
+  return sub();
+}
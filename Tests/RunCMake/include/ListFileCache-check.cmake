@@ -0,0 +1,5 @@
+file(GLOB cached "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/ListFileCache/*.bin")
+list(LENGTH cached count)
+if(count LESS 2)
+  set(RunCMake_TEST_FAILED "Parsed list files not stored:\n  ${cached}")
+endif()
@@ -0,0 +1,4 @@
+include(${CMAKE_CURRENT_LIST_DIR}/ListFileCacheHelper.cmake)
+if(NOT "${helper_value}" STREQUAL "a;b c;[[d]]")
+  message(FATAL_ERROR "helper_value is \"${helper_value}\"")
+endif()
@@ -0,0 +1 @@
+set(helper_value a "b c" [==[[[d]]]==])
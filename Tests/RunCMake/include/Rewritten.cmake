@@ -0,0 +1,8 @@
+set(file "${CMAKE_CURRENT_BINARY_DIR}/rewritten.cmake")
+file(WRITE "${file}" "set(value 1)\n")
+include("${file}")
+file(WRITE "${file}" "set(value 2)\n")
+include("${file}")
+if(NOT value EQUAL 2)
+  message(FATAL_ERROR "include() did not pick up rewritten file: ${value}")
+endif()
@@ -5,3 +5,16 @@ run_cmake(EmptyStringOptional)
 run_cmake(CMP0024-WARN)
 run_cmake(CMP0024-NEW)
 run_cmake(ExportExportInclude)
+run_cmake(Rewritten)
+
+# Configure twice so the second run reads the stored parse results.
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ListFileCache-build)
+set(RunCMake_TEST_NO_CLEAN 1)
+set(RunCMake_TEST_OPTIONS -DCMAKE_LIST_FILE_CACHE=ON)
+file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+run_cmake(ListFileCache)
+set(RunCMake_TEST_OPTIONS -DCMAKE_LIST_FILE_CACHE=ON --debug-output)
+run_cmake(ListFileCache-reuse)
+unset(RunCMake_TEST_OPTIONS)
+unset(RunCMake_TEST_NO_CLEAN)
+unset(RunCMake_TEST_BINARY_DIR)
@@ -0,0 +1,9 @@
+foreach(t a b c)
+  file(READ ${RunCMake_TEST_BINARY_DIR}/CMakeFiles/${t}.dir/flags.make
+    ${t}_flags)
+endforeach()
+if(NOT a_flags MATCHES "/x_inc" OR NOT c_flags MATCHES "/x_inc")
+  set(RunCMake_TEST_FAILED "Targets a and c do not use /x_inc.")
+elseif(b_flags MATCHES "/x_inc")
+  set(RunCMake_TEST_FAILED "Target b uses /x_inc:\n${b_flags}")
+endif()
@@ -0,0 +1,13 @@
+enable_language(CXX)
+
+add_library(x INTERFACE)
+set_property(TARGET x PROPERTY INTERFACE_INCLUDE_DIRECTORIES /x_inc)
+add_library(dep INTERFACE)
+set_property(TARGET dep PROPERTY
+  INTERFACE_LINK_LIBRARIES "$<$<BOOL:$<TARGET_PROPERTY:WANT_X>>:x>")
+
+foreach(t a b c)
+  add_library(${t} STATIC empty.cpp)
+  target_link_libraries(${t} dep)
+endforeach()
+set_property(TARGET a c PROPERTY WANT_X 1)
@@ -0,0 +1,10 @@
+enable_language(CXX)
+
+add_library(dep INTERFACE)
+set_property(TARGET dep PROPERTY INTERFACE_INCLUDE_DIRECTORIES
+  "$<NOT_A_GENEX>")
+
+add_library(a STATIC empty.cpp)
+add_library(b STATIC empty.cpp)
+target_link_libraries(a dep)
+target_link_libraries(b dep)
@@ -7,3 +7,8 @@ run_cmake(ImportedTarget)
 run_cmake(CMP0021)
 run_cmake(install_config)
 run_cmake(incomplete-genex)
+run_cmake(InterfaceError)
+
+if(RunCMake_GENERATOR MATCHES "Make")
+  run_cmake(HeadSensitiveInterface)
+endif()
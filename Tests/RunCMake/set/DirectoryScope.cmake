@@ -0,0 +1,31 @@
+macro(check_var dir var expect)
+  get_directory_property(value DIRECTORY ${dir} DEFINITION ${var})
+  if(NOT "${value}" STREQUAL "${expect}")
+    message(FATAL_ERROR "${var} in ${dir} is \"${value}\", not \"${expect}\"")
+  endif()
+endmacro()
+
+set(A a)
+set(B b)
+add_subdirectory(DirectoryScope/one)
+check_var(. A a)
+check_var(. B b)
+check_var(. C c)
+
+set(A a2)
+unset(B)
+add_subdirectory(DirectoryScope/two)
+
+function(add_three)
+  set(D d)
+  add_subdirectory(DirectoryScope/three)
+endfunction()
+add_three()
+
+set(A a3)
+check_var(DirectoryScope/one A one)
+check_var(DirectoryScope/one B "")
+check_var(DirectoryScope/two A a2)
+check_var(DirectoryScope/two B "")
+check_var(DirectoryScope/three A a3)
+check_var(DirectoryScope/three D d)